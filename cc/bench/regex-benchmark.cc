@@ -0,0 +1,151 @@
+// Runs every extractor pattern against a corpus of cell strings with each
+// available regex backend and with the compile time patterns, reports time
+// per backend and per pattern, and the patterns where backends disagree.
+//
+// regex-benchmark <corpus> [repeat]
+//   corpus: .xlsx or .csv (all string cells of all sheets) or text file (one cell per line)
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <numeric>
+
+#include "ext/fmt.hh"
+#include "utils/log.hh"
+#include "utils/regex-backend.hh"
+#include "xlsx/xlsx.hh"
+#include "xlsx/sheet-extractor.hh"
+
+// ----------------------------------------------------------------------
+
+static std::vector<std::string> read_corpus(const std::filesystem::path& filename);
+
+struct engine_result_t
+{
+    std::string name;
+    std::vector<double> milliseconds; // per pattern
+    std::vector<size_t> matches;      // per pattern
+    double total() const { return std::accumulate(std::begin(milliseconds), std::end(milliseconds), 0.0); }
+};
+
+using search_t = std::function<bool(std::string_view)>;
+
+static engine_result_t run(std::string_view name, const std::vector<search_t>& searches, const std::vector<std::string>& corpus, size_t repeat);
+
+// ----------------------------------------------------------------------
+
+int main(int argc, char* const argv[])
+{
+    if (argc < 2 || argc > 3) {
+        fmt::print(stderr, "Usage: {} <corpus.xlsx|corpus.csv|corpus.txt> [repeat]\n", argv[0]);
+        return 1;
+    }
+
+    try {
+        const auto corpus = read_corpus(argv[1]);
+        const size_t repeat = argc > 2 ? std::stoul(argv[2]) : 1;
+        const auto patterns = ae::xlsx::extractor_patterns();
+        fmt::print("corpus: {} cells, {} patterns, repeat: {}, default backend: {}\n", corpus.size(), patterns.size(), repeat, ae::regex::backend_name(ae::regex::default_backend()));
+
+        std::vector<engine_result_t> results;
+
+        std::vector<search_t> static_searches;
+        for (const auto& pattern : patterns)
+            static_searches.push_back([program = pattern.program](std::string_view input) { return ae::regex::search(input, program); });
+        results.push_back(run("static", static_searches, corpus, repeat));
+
+        for (const auto backend : ae::regex::available_backends()) {
+            std::vector<search_t> searches;
+            for (const auto& pattern : patterns) {
+                try {
+                    searches.push_back([re = ae::regex::regex_t{pattern.pattern, true, backend}](std::string_view input) { return re.search(input); });
+                }
+                catch (std::invalid_argument& err) {
+                    fmt::print(stderr, "> {}: {}: {}\n", ae::regex::backend_name(backend), pattern.name, err.what());
+                    searches.push_back([](std::string_view) { return false; });
+                }
+            }
+            results.push_back(run(ae::regex::backend_name(backend), searches, corpus, repeat));
+        }
+
+        fmt::print("\n{:<45s}", "pattern, ms");
+        for (const auto& result : results)
+            fmt::print(" {:>10s}", result.name);
+        fmt::print("\n");
+        for (size_t pattern_no = 0; pattern_no < patterns.size(); ++pattern_no) {
+            fmt::print("{:<45s}", patterns[pattern_no].name);
+            for (const auto& result : results)
+                fmt::print(" {:10.2f}", result.milliseconds[pattern_no]);
+            for (const auto& result : results) {
+                if (result.matches[pattern_no] != results.front().matches[pattern_no])
+                    fmt::print("  [{}: {} matches, static: {}]", result.name, result.matches[pattern_no], results.front().matches[pattern_no]);
+            }
+            fmt::print("\n");
+        }
+        fmt::print("{:<45s}", "TOTAL");
+        for (const auto& result : results)
+            fmt::print(" {:10.2f}", result.total());
+        fmt::print("\n");
+
+        const auto prefilter = ae::regex::prefilter_statistics();
+        fmt::print("\nprefilter: tested {} skipped {} ({:.1f}%)\n", prefilter.tested, prefilter.skipped,
+                   prefilter.tested ? static_cast<double>(prefilter.skipped) * 100.0 / static_cast<double>(prefilter.tested) : 0.0);
+        return 0;
+    }
+    catch (std::exception& err) {
+        AD_ERROR("{}", err.what());
+        return 2;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+std::vector<std::string> read_corpus(const std::filesystem::path& filename)
+{
+    std::vector<std::string> corpus;
+    if (const auto ext = filename.extension(); ext == ".xlsx" || ext == ".csv") {
+        auto doc = ae::xlsx::open(filename);
+        for (size_t sheet_no = 0; sheet_no < doc->number_of_sheets(); ++sheet_no) {
+            const auto sheet = doc->sheet(sheet_no);
+            for (ae::xlsx::nrow_t row{0}; row < sheet->number_of_rows(); ++row) {
+                for (const auto& cell : sheet->row(row)) {
+                    if (cell.is_string())
+                        corpus.emplace_back(cell.str());
+                }
+            }
+            doc->release(sheet_no);
+        }
+    }
+    else {
+        std::ifstream input{filename};
+        if (!input)
+            throw std::runtime_error{fmt::format("cannot read {}", filename)};
+        for (std::string line; std::getline(input, line);)
+            corpus.push_back(std::move(line));
+    }
+    return corpus;
+
+} // read_corpus
+
+// ----------------------------------------------------------------------
+
+engine_result_t run(std::string_view name, const std::vector<search_t>& searches, const std::vector<std::string>& corpus, size_t repeat)
+{
+    engine_result_t result{.name = std::string{name}, .milliseconds = std::vector<double>(searches.size(), 0.0), .matches = std::vector<size_t>(searches.size(), 0)};
+    for (size_t pattern_no = 0; pattern_no < searches.size(); ++pattern_no) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t iteration = 0; iteration < repeat; ++iteration) {
+            size_t matches{0};
+            for (const auto& cell : corpus) {
+                if (searches[pattern_no](cell))
+                    ++matches;
+            }
+            result.matches[pattern_no] = matches;
+        }
+        result.milliseconds[pattern_no] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return result;
+
+} // run
+
+// ----------------------------------------------------------------------
@@ -38,6 +38,7 @@
 #include <pybind11/stl_bind.h>
 #include <pybind11/embed.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 
 #pragma GCC diagnostic pop
 
@@ -2,11 +2,16 @@
 #include "utils/log.hh"
 #include "xlsx/xlsx.hh"
 #include "xlsx/sheet-extractor.hh"
+#include "xlsx/cell-index.hh"
+#include "xlsx/sheet-query.hh"
+#include "xlsx/sheet-arrow.hh"
 
 // ======================================================================
 
 namespace ae::xlsx::inline v1
 {
+    constexpr const int16_t logged_no_value{std::numeric_limits<int16_t>::min()};
+
     inline detect_result_t sheet_detected(pybind11::object detected)
     {
         detect_result_t result;
@@ -35,6 +40,196 @@ namespace ae::xlsx::inline v1
             result.date = ae::date::from_string(date, date::allow_incomplete::no, date::throw_on_error::no, result.lab == "CDC" ? date::month_first::yes : date::month_first::no);
         return result;
     }
+
+    // python passes the last row and column to look in, max_row_col for the sheet end
+    inline std::pair<cell_addr_t, cell_addr_t> grep_region(const Sheet& sheet, size_t min_row, size_t max_row, size_t min_col, size_t max_col)
+    {
+        if (max_row == max_row_col)
+            max_row = *sheet.number_of_rows();
+        else
+            ++max_row;
+        if (max_col == max_row_col)
+            max_col = *sheet.number_of_columns();
+        else
+            ++max_col;
+        return {{nrow_t{min_row}, ncol_t{min_col}}, {nrow_t{max_row}, ncol_t{max_col}}};
+    }
+
+    inline ae::regex::regex_t grep_regex(const std::string& rex, const std::string& backend) { return ae::regex::regex_t{rex, true, backend.empty() ? ae::regex::default_backend() : ae::regex::backend_from_name(backend)}; }
+
+    // terms: [(rows, cols, what, value)], what: "regex" (groups reported, string cells only), "text" (whole text equals), "kind" (cell_kind_from_string)
+    inline sheet_query_t sheet_query(const std::vector<std::tuple<ssize_t, ssize_t, std::string, std::string>>& terms, const std::string& backend)
+    {
+        sheet_query_t query;
+        for (const auto& [rows, cols, what, value] : terms) {
+            if (what == "regex")
+                query.at(rows, cols, grep_regex(value, backend), sheet_query_t::capture::yes);
+            else if (what == "text")
+                query.at(rows, cols, sheet_query_t::text_t{value});
+            else if (what == "kind")
+                query.at(rows, cols, cell_kind_from_string(value));
+            else
+                throw std::invalid_argument{fmt::format("query term: unrecognized \"{}\", expected \"regex\", \"text\" or \"kind\"", what)};
+        }
+        return query;
+    }
+
+    inline std::vector<std::pair<size_t, size_t>> cell_positions(const std::vector<cell_addr_t>& cells)
+    {
+        std::vector<std::pair<size_t, size_t>> result(cells.size());
+        std::transform(std::begin(cells), std::end(cells), std::begin(result), [](const cell_addr_t& addr) { return std::pair{*addr.row, *addr.col}; });
+        return result;
+    }
+
+    // titer_t::qualifier_t names, python uses them to interpret the qualifier array of titer_matrix()
+    constexpr const std::array<std::string_view, 10> titer_qualifier_names{"invalid", "exact", "less", "more", "dont_care", "not_done", "not_available", "not_tested", "qns", "comma"};
+    static_assert(titer_qualifier_names.size() == static_cast<size_t>(titer_t::qualifier_t::comma) + 1);
+
+    // (logged, qualifier) arrays [antigen, serum] in one pass over the sheet,
+    // logged is log2(titer/10) rounded (-1 for 5, 7 for 1280), logged_no_value if titer has no value ("*", "ND", "<"),
+    // the read titer of Crick PRN pairs is used
+    // arrays are views of the C++ buffers, freed when both arrays are gone
+    inline pybind11::tuple titer_matrix(const Extractor& extractor)
+    {
+        struct buffers_t
+        {
+            std::vector<int16_t> logged;
+            std::vector<uint8_t> qualifier;
+        };
+
+        const auto titers = extractor.titers();
+        const auto number_of_antigens = titers.number_of_antigens(), number_of_sera = titers.number_of_sera();
+        auto buffers = std::make_unique<buffers_t>(buffers_t{std::vector<int16_t>(number_of_antigens * number_of_sera), std::vector<uint8_t>(number_of_antigens * number_of_sera)});
+        for (size_t ag_no = 0; ag_no < number_of_antigens; ++ag_no) {
+            for (size_t sr_no = 0; sr_no < number_of_sera; ++sr_no) {
+                const auto titer = titers.titer(ag_no, sr_no);
+                const auto cell_no = ag_no * number_of_sera + sr_no;
+                buffers->logged[cell_no] = titer.value() == 0 ? logged_no_value : static_cast<int16_t>(std::lround(titer.log2()));
+                buffers->qualifier[cell_no] = static_cast<uint8_t>(titer.qualifier());
+            }
+        }
+
+        const std::array<ssize_t, 2> shape{static_cast<ssize_t>(number_of_antigens), static_cast<ssize_t>(number_of_sera)};
+        auto* data = buffers.get();
+        pybind11::capsule owner{buffers.release(), [](void* ptr) { delete static_cast<buffers_t*>(ptr); }};
+        return pybind11::make_tuple(pybind11::array_t<int16_t>(shape, data->logged.data(), owner), pybind11::array_t<uint8_t>(shape, data->qualifier.data(), owner));
+    }
+
+    inline pybind11::list antigen_dicts(const Extractor& extractor)
+    {
+        using namespace pybind11::literals;
+        pybind11::list result;
+        for (const auto& antigen : extractor.antigens())
+            result.append(pybind11::dict("name"_a = antigen.name, "date"_a = antigen.date, "passage"_a = antigen.passage, "lab_id"_a = antigen.lab_id));
+        return result;
+    }
+
+    inline pybind11::list serum_dicts(const Extractor& extractor)
+    {
+        using namespace pybind11::literals;
+        pybind11::list result;
+        for (const auto& serum : extractor.sera())
+            result.append(pybind11::dict("name"_a = serum.name, "serum_id"_a = serum.serum_id, "passage"_a = serum.passage, "species"_a = serum.species, "conc"_a = serum.conc, "dilut"_a = serum.dilut,
+                                         "boosted"_a = serum.boosted));
+        return result;
+    }
+
+    // Arrow PyCapsule interface: __arrow_c_array__() returns ("arrow_schema", "arrow_array") capsules,
+    // pyarrow.record_batch(sheet.to_arrow()), export is made at each call, keeps the sheet alive
+    class arrow_export_t
+    {
+      public:
+        arrow_export_t(std::shared_ptr<const Sheet> sheet) : sheet_{std::move(sheet)} {}
+
+        pybind11::tuple arrow_c_array(pybind11::object requested_schema) const
+        {
+            if (!requested_schema.is_none())
+                AD_WARNING("Sheet.to_arrow: requested_schema ignored");
+            auto schema = std::make_unique<ArrowSchema>();
+            auto array = std::make_unique<ArrowArray>();
+            to_arrow(*sheet_, *schema, *array);
+            auto schema_capsule = pybind11::reinterpret_steal<pybind11::capsule>(PyCapsule_New(schema.get(), "arrow_schema", &release_schema_capsule));
+            if (!schema_capsule)
+                throw pybind11::error_already_set{};
+            schema.release(); // owned by the capsule
+            auto array_capsule = pybind11::reinterpret_steal<pybind11::capsule>(PyCapsule_New(array.get(), "arrow_array", &release_array_capsule));
+            if (!array_capsule)
+                throw pybind11::error_already_set{};
+            array.release();
+            return pybind11::make_tuple(schema_capsule, array_capsule);
+        }
+
+      private:
+        std::shared_ptr<const Sheet> sheet_;
+
+        // consumer marks the struct released when it takes the data over
+        static void release_schema_capsule(PyObject* capsule)
+        {
+            auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+            if (schema->release != nullptr)
+                schema->release(schema);
+            delete schema;
+        }
+
+        static void release_array_capsule(PyObject* capsule)
+        {
+            auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(capsule, "arrow_array"));
+            if (array->release != nullptr)
+                array->release(array);
+            delete array;
+        }
+    };
+
+    // object array [row, column] of cell text as in Sheet.cell_as_str, None for empty cells
+    inline pybind11::array sheet_to_numpy(const Sheet& sheet)
+    {
+        const auto number_of_rows = *sheet.number_of_rows(), number_of_columns = *sheet.number_of_columns();
+        std::vector<pybind11::object> cells;
+        cells.reserve(number_of_rows * number_of_columns);
+        for (nrow_t row{0}; row < sheet.number_of_rows(); ++row) {
+            const auto row_cells = sheet.row(row);
+            for (size_t col = 0; col < number_of_columns; ++col) {
+                if (const auto cell = row_cells.at(col); cell.is_empty())
+                    cells.push_back(pybind11::none());
+                else
+                    cells.push_back(pybind11::str(cell.text().data(), cell.text().size()));
+            }
+        }
+
+        pybind11::array result{pybind11::dtype{"O"}, std::array<ssize_t, 2>{static_cast<ssize_t>(number_of_rows), static_cast<ssize_t>(number_of_columns)}};
+        auto** data = static_cast<PyObject**>(result.mutable_data());
+        for (auto& cell : cells) { // object array is created filled with None or NULL
+            Py_XDECREF(*data);
+            *data++ = cell.release().ptr();
+        }
+        return result;
+    }
+
+    // python iterator over Sheet::grep_lazy, keeps the sheet alive
+    class grep_iterator_t
+    {
+      public:
+        grep_iterator_t(std::shared_ptr<const Sheet> sheet, const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) : sheet_{std::move(sheet)}, range_{sheet_->grep_lazy(rex, min, max)} {}
+        grep_iterator_t(const grep_iterator_t&) = delete;
+        grep_iterator_t& operator=(const grep_iterator_t&) = delete;
+
+        cell_match_t next()
+        {
+            if (!current_.has_value())
+                current_ = range_.begin();
+            else if (*current_ != range_.end())
+                ++*current_;
+            if (*current_ == range_.end())
+                throw pybind11::stop_iteration{};
+            return (*current_)->to_match();
+        }
+
+      private:
+        std::shared_ptr<const Sheet> sheet_;
+        grep_range_t<ae::regex::regex_t> range_;
+        std::optional<grep_range_t<ae::regex::regex_t>::iterator> current_{}; // nullopt before the first next()
+    };
+
 } // namespace ae::xlsx::inline v1
 
 // ----------------------------------------------------------------------
@@ -59,9 +254,28 @@ PYBIND11_MODULE(ae_whocc, mdl)
         },
         "sheet"_a, "detected"_a, "warn_if_not_found"_a = true);
 
+    xlsx_submodule.def(
+        "regex_prefilter_statistics",
+        [](bool reset) {
+            const auto stat = ae::regex::prefilter_statistics();
+            if (reset)
+                ae::regex::reset_prefilter_statistics();
+            return pybind11::dict("tested"_a = stat.tested, "skipped"_a = stat.skipped);
+        },
+        "reset"_a = false, pybind11::doc("number of cells tested by regex prefilters and how many of them were skipped without running regex"));
+
     pybind11::class_<ae::xlsx::Doc, std::shared_ptr<ae::xlsx::Doc>>(xlsx_submodule, "Doc") //
         .def("number_of_sheets", &ae::xlsx::Doc::number_of_sheets)                         //
-        .def("sheet", &ae::xlsx::Doc::sheet, "sheet_no"_a)                                 //
+        .def(
+            "sheet",
+            [](ae::xlsx::Doc& doc, size_t sheet_no, bool token_index) {
+                auto sheet = doc.sheet(sheet_no);
+                if (token_index)
+                    sheet->token_index();
+                return sheet;
+            },
+            "sheet_no"_a, "token_index"_a = false, pybind11::doc("token_index: build the token index of the sheet, for many grep calls on it and cells_with_token()")) //
+        .def("release", &ae::xlsx::Doc::release, "sheet_no"_a, pybind11::doc("drop cached sheet to free memory")) //
         ;
 
     pybind11::class_<ae::xlsx::Sheet, std::shared_ptr<ae::xlsx::Sheet>>(xlsx_submodule, "Sheet")           //
@@ -69,24 +283,112 @@ PYBIND11_MODULE(ae_whocc, mdl)
         .def("number_of_rows", [](const ae::xlsx::Sheet& sheet) { return *sheet.number_of_rows(); })       //
         .def("number_of_columns", [](const ae::xlsx::Sheet& sheet) { return *sheet.number_of_columns(); }) //
         .def(
-            "cell_as_str", [](const ae::xlsx::Sheet& sheet, size_t row, size_t column) { return fmt::format("{}", sheet.cell(ae::xlsx::nrow_t{row}, ae::xlsx::ncol_t{column})); }, "row"_a,
+            "cell_as_str", [](const ae::xlsx::Sheet& sheet, size_t row, size_t column) { return std::string{sheet.text(ae::xlsx::nrow_t{row}, ae::xlsx::ncol_t{column})}; }, "row"_a,
             "column"_a) //
         .def(
             "grep",
-            [](const ae::xlsx::Sheet& sheet, const std::string& rex, size_t min_row, size_t max_row, size_t min_col, size_t max_col) {
-                if (max_row == ae::xlsx::max_row_col)
-                    max_row = *sheet.number_of_rows();
-                else
-                    ++max_row;
-                if (max_col == ae::xlsx::max_row_col)
-                    max_col = *sheet.number_of_columns();
-                else
-                    ++max_col;
-                return sheet.grep(std::regex(rex, std::regex::icase | std::regex::ECMAScript | std::regex::optimize), {ae::xlsx::nrow_t{min_row}, ae::xlsx::ncol_t{min_col}},
-                                  {ae::xlsx::nrow_t{max_row}, ae::xlsx::ncol_t{max_col}});
-            },                                                                                                                     //
-            "regex"_a, "min_row"_a = 0, "max_row"_a = ae::xlsx::max_row_col, "min_col"_a = 0, "max_col"_a = ae::xlsx::max_row_col, //
-            pybind11::doc("max_row and max_col are the last row and col to look in"))                                              //
+            [](const ae::xlsx::Sheet& sheet, const std::string& rex, size_t min_row, size_t max_row, size_t min_col, size_t max_col, const std::string& backend) {
+                const auto [min, max] = ae::xlsx::grep_region(sheet, min_row, max_row, min_col, max_col);
+                return sheet.grep(ae::xlsx::grep_regex(rex, backend), min, max);
+            },                                                                                                                                              //
+            "regex"_a, "min_row"_a = 0, "max_row"_a = ae::xlsx::max_row_col, "min_col"_a = 0, "max_col"_a = ae::xlsx::max_row_col, "backend"_a = std::string{}, //
+            pybind11::doc("max_row and max_col are the last row and col to look in, backend: \"std\", \"pike\", \"pcre2\", empty for the build default")) //
+        .def(
+            "to_arrow", [](std::shared_ptr<ae::xlsx::Sheet> sheet) { return ae::xlsx::arrow_export_t{std::move(sheet)}; },
+            pybind11::doc("whole sheet in one pass, Arrow PyCapsule interface: pyarrow.record_batch(sheet.to_arrow()), one nullable string column per sheet column named \"0\", \"1\", ...")) //
+        .def("to_numpy", &ae::xlsx::sheet_to_numpy, pybind11::doc("whole sheet in one pass, numpy object array [row, column]: str as cell_as_str(), None for empty cells")) //
+        .def(
+            "grep_lazy",
+            [](std::shared_ptr<ae::xlsx::Sheet> sheet, const std::string& rex, size_t min_row, size_t max_row, size_t min_col, size_t max_col, const std::string& backend) {
+                const auto [min, max] = ae::xlsx::grep_region(*sheet, min_row, max_row, min_col, max_col);
+                return std::make_shared<ae::xlsx::grep_iterator_t>(std::move(sheet), ae::xlsx::grep_regex(rex, backend), min, max);
+            },                                                                                                                                              //
+            "regex"_a, "min_row"_a = 0, "max_row"_a = ae::xlsx::max_row_col, "min_col"_a = 0, "max_col"_a = ae::xlsx::max_row_col, "backend"_a = std::string{}, //
+            pybind11::doc("iterator over the matches of grep, cells are scanned while iterating: next(sheet.grep_lazy(...), None) stops at the first match")) //
+        .def(
+            "query",
+            [](const ae::xlsx::Sheet& sheet, const std::vector<std::tuple<ssize_t, ssize_t, std::string, std::string>>& terms, size_t min_row, size_t max_row, size_t min_col, size_t max_col,
+               const std::string& backend) {
+                const auto [min, max] = ae::xlsx::grep_region(sheet, min_row, max_row, min_col, max_col);
+                std::vector<std::pair<std::pair<size_t, size_t>, std::vector<ae::xlsx::cell_match_t>>> result;
+                for (const auto& found : ae::xlsx::sheet_query(terms, backend).find_all(sheet, min, max)) {
+                    auto& [anchor, cells] = result.emplace_back(std::pair{*found.row, *found.col}, std::vector<ae::xlsx::cell_match_t>{});
+                    for (const auto& cell : found.cells)
+                        cells.push_back(cell.to_match());
+                }
+                return result;
+            },                                                                                                                                                          //
+            "terms"_a, "min_row"_a = 0, "max_row"_a = ae::xlsx::max_row_col, "min_col"_a = 0, "max_col"_a = ae::xlsx::max_row_col, "backend"_a = std::string{}, //
+            pybind11::doc("terms: [(rows, cols, \"regex\"|\"text\"|\"kind\", value)], rows and cols relative to the anchor cell in the region,\n"
+                          "returns [((anchor_row, anchor_col), [cell_match_t for each term])], e.g. [(0, 0, \"regex\", \"^LABEL$\"), (0, 1, \"kind\", \"integer\")]")) //
+        .def(
+            "cells_with_token", [](const ae::xlsx::Sheet& sheet, std::string_view token) { return ae::xlsx::cell_positions(sheet.token_index().cells(token)); }, "token"_a,
+            pybind11::doc("[(row, col)] of the cells having the token, case and whitespace insensitive, builds the token index on first use")) //
+        .def(
+            "cells_with_prefix", [](const ae::xlsx::Sheet& sheet, std::string_view prefix) { return ae::xlsx::cell_positions(sheet.token_index().cells_with_prefix(prefix)); }, "prefix"_a,
+            pybind11::doc("[(row, col)] of the cells having a token starting with prefix")) //
+        .def(
+            "cells_with_tokens", [](const ae::xlsx::Sheet& sheet, std::string_view text) { return ae::xlsx::cell_positions(sheet.token_index().cells_with_tokens(text)); }, "text"_a,
+            pybind11::doc("[(row, col)] of the cells having all tokens of text, e.g. \"Sample Date\"")) //
+        .def(
+            "titer_range",
+            [](const ae::xlsx::Sheet& sheet, size_t row) -> std::optional<std::pair<size_t, size_t>> {
+                if (const auto cr = sheet.titer_range(ae::xlsx::nrow_t{row}); cr.valid())
+                    return std::pair{*cr.first, *cr.second};
+                return std::nullopt;
+            },
+            "row"_a, pybind11::doc("first longest run of titer-like cells in the row, [first, last] columns, None if not found")) //
+        .def(
+            "longest_run_in_row",
+            [](const ae::xlsx::Sheet& sheet, size_t row, const std::string& kind) -> std::optional<std::pair<size_t, size_t>> {
+                if (const auto cr = sheet.type_index().longest_run(ae::xlsx::nrow_t{row}, ae::xlsx::cell_kind_from_string(kind)); cr.valid())
+                    return std::pair{*cr.first, *cr.second};
+                return std::nullopt;
+            },
+            "row"_a, "kind"_a, pybind11::doc("kind: non-empty, string, integer, double, date, titer")) //
+        .def(
+            "longest_run_in_column",
+            [](const ae::xlsx::Sheet& sheet, size_t column, const std::string& kind) -> std::optional<std::pair<size_t, size_t>> {
+                if (const auto rr = sheet.type_index().longest_run(ae::xlsx::ncol_t{column}, ae::xlsx::cell_kind_from_string(kind)); rr.valid())
+                    return std::pair{*rr.first, *rr.second};
+                return std::nullopt;
+            },
+            "column"_a, "kind"_a, pybind11::doc("kind: non-empty, string, integer, double, date, titer")) //
+        .def(
+            "count_in_row", [](const ae::xlsx::Sheet& sheet, size_t row, const std::string& kind) { return sheet.type_index().row(ae::xlsx::nrow_t{row}, ae::xlsx::cell_kind_from_string(kind)).count(); },
+            "row"_a, "kind"_a) //
+        .def(
+            "count_in_column",
+            [](const ae::xlsx::Sheet& sheet, size_t column, const std::string& kind) { return sheet.type_index().column(ae::xlsx::ncol_t{column}, ae::xlsx::cell_kind_from_string(kind)).count(); },
+            "column"_a, "kind"_a) //
+        .def(
+            "columns_in_row",
+            [](const ae::xlsx::Sheet& sheet, size_t row, const std::string& kind) {
+                std::vector<size_t> columns;
+                sheet.type_index().row(ae::xlsx::nrow_t{row}, ae::xlsx::cell_kind_from_string(kind)).for_each([&columns](size_t col) { columns.push_back(col); });
+                return columns;
+            },
+            "row"_a, "kind"_a) //
+        .def(
+            "rows_in_column",
+            [](const ae::xlsx::Sheet& sheet, size_t column, const std::string& kind) {
+                std::vector<size_t> rows;
+                sheet.type_index().column(ae::xlsx::ncol_t{column}, ae::xlsx::cell_kind_from_string(kind)).for_each([&rows](size_t row) { rows.push_back(row); });
+                return rows;
+            },
+            "column"_a, "kind"_a) //
+        .def("last_non_empty_row",
+             [](const ae::xlsx::Sheet& sheet) -> std::optional<size_t> {
+                 if (const auto row = sheet.type_index().last_non_empty_row(); row.has_value())
+                     return **row;
+                 return std::nullopt;
+             }) //
+        .def("last_non_empty_column",
+             [](const ae::xlsx::Sheet& sheet) -> std::optional<size_t> {
+                 if (const auto col = sheet.type_index().last_non_empty_column(); col.has_value())
+                     return **col;
+                 return std::nullopt;
+             }) //
         ;
 
     pybind11::class_<ae::xlsx::cell_match_t>(xlsx_submodule, "cell_match_t")                                                                   //
@@ -96,7 +398,25 @@ PYBIND11_MODULE(ae_whocc, mdl)
         .def("__repr__", [](const ae::xlsx::cell_match_t& cm) { return fmt::format("<cell_match_t: {}:{} {}>", cm.row, cm.col, cm.matches); }) //
         ;
 
-    pybind11::class_<ae::xlsx::Extractor, std::shared_ptr<ae::xlsx::Extractor>>(xlsx_submodule, "Extractor")           //
+    pybind11::class_<ae::xlsx::arrow_export_t>(xlsx_submodule, "arrow_export_t") //
+        .def("__arrow_c_array__", &ae::xlsx::arrow_export_t::arrow_c_array, "requested_schema"_a = pybind11::none()) //
+        ;
+
+    pybind11::class_<ae::xlsx::grep_iterator_t, std::shared_ptr<ae::xlsx::grep_iterator_t>>(xlsx_submodule, "grep_iterator_t") //
+        .def("__iter__", [](std::shared_ptr<ae::xlsx::grep_iterator_t> iter) { return iter; })                              //
+        .def("__next__", &ae::xlsx::grep_iterator_t::next)                                                                     //
+        ;
+
+    xlsx_submodule.attr("titer_qualifiers") = ae::xlsx::titer_qualifier_names;
+    xlsx_submodule.attr("logged_titer_no_value") = ae::xlsx::logged_no_value;
+
+    pybind11::class_<ae::xlsx::Extractor, std::shared_ptr<ae::xlsx::Extractor>>(xlsx_submodule, "Extractor")                                                                     //
+        .def("number_of_antigens", &ae::xlsx::Extractor::number_of_antigens)                                                                                                      //
+        .def("number_of_sera", &ae::xlsx::Extractor::number_of_sera)                                                                                                              //
+        .def("titer_matrix", &ae::xlsx::titer_matrix,                                                                                                                             //
+             pybind11::doc("(logged, qualifier) numpy arrays [antigen, serum]: int16 log2(titer/10) (logged_titer_no_value if titer has no value), uint8 index in titer_qualifiers")) //
+        .def("antigens", &ae::xlsx::antigen_dicts, pybind11::doc("list of dicts: name, date, passage, lab_id"))                                                                    //
+        .def("sera", &ae::xlsx::serum_dicts, pybind11::doc("list of dicts: name, serum_id, passage, species, conc, dilut, boosted"))                                              //
         ;
 
 }
@@ -0,0 +1,151 @@
+// to_arrow buffers against a generated sheet: offsets, text, validity bitmap and
+// null_count of every column, then release with children moved out first
+// (consumers may do that, each child must stay valid on its own).
+//
+// arrow
+//   exit code 1 if any difference is found
+
+#include <random>
+
+#include "ext/fmt.hh"
+#include "xlsx/materialized-sheet.hh"
+#include "xlsx/sheet-arrow.hh"
+
+// ----------------------------------------------------------------------
+
+// random cells of every kind, about a quarter of them empty (null in arrow)
+class test_sheet_t : public ae::xlsx::MaterializedSheet
+{
+  public:
+    test_sheet_t(size_t rows, size_t cols);
+};
+
+static size_t check_column(const ae::xlsx::Sheet& sheet, size_t col, const ArrowSchema& schema, const ArrowArray& array);
+
+// ----------------------------------------------------------------------
+
+int main()
+{
+    const test_sheet_t sheet{300, 7};
+
+    ArrowSchema schema;
+    ArrowArray array;
+    ae::xlsx::to_arrow(sheet, schema, array);
+
+    size_t differences{0}, nulls{0};
+    const auto report = [&differences](bool ok, std::string_view what) {
+        if (!ok) {
+            fmt::print(stderr, "> {}\n", what);
+            ++differences;
+        }
+    };
+    report(std::string_view{schema.format} == "+s" && schema.n_children == static_cast<int64_t>(*sheet.number_of_columns()), "struct schema");
+    report(array.length == static_cast<int64_t>(*sheet.number_of_rows()) && array.n_children == schema.n_children && array.null_count == 0 && array.n_buffers == 1, "struct array");
+    for (int64_t col = 0; col < array.n_children; ++col) {
+        differences += check_column(sheet, static_cast<size_t>(col), *schema.children[col], *array.children[col]);
+        nulls += static_cast<size_t>(array.children[col]->null_count);
+    }
+    report(nulls > 0, "no null cells in the test sheet");
+
+    // children moved out, then parents released, then children
+    ArrowArray moved_array = *array.children[0];
+    array.children[0]->release = nullptr;
+    ArrowSchema moved_schema = *schema.children[1];
+    schema.children[1]->release = nullptr;
+    array.release(&array);
+    schema.release(&schema);
+    report(array.release == nullptr && schema.release == nullptr, "struct release");
+    report(std::string_view{moved_schema.name} == "1", "moved schema name after struct release");
+    differences += check_column(sheet, 0, ArrowSchema{.format = "u", .name = "0"}, moved_array);
+    moved_array.release(&moved_array);
+    moved_schema.release(&moved_schema);
+    report(moved_array.release == nullptr && moved_schema.release == nullptr, "moved children release");
+
+    fmt::print("rows: {} columns: {} nulls: {} differences: {}\n", *sheet.number_of_rows(), *sheet.number_of_columns(), nulls, differences);
+    return differences == 0 ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------
+
+size_t check_column(const ae::xlsx::Sheet& sheet, size_t col, const ArrowSchema& schema, const ArrowArray& array)
+{
+    size_t differences{0};
+    if (std::string_view{schema.name} != fmt::format("{}", col) || std::string_view{schema.format} != "u") {
+        fmt::print(stderr, "> column {}: schema name \"{}\" format \"{}\"\n", col, schema.name, schema.format);
+        ++differences;
+    }
+    if (array.length != static_cast<int64_t>(*sheet.number_of_rows()) || array.n_buffers != 3 || array.offset != 0) {
+        fmt::print(stderr, "> column {}: length {} n_buffers {} offset {}\n", col, array.length, array.n_buffers, array.offset);
+        return differences + 1;
+    }
+
+    const auto* validity = static_cast<const uint8_t*>(array.buffers[0]);
+    const auto* offsets = static_cast<const int32_t*>(array.buffers[1]);
+    const auto* text = static_cast<const char*>(array.buffers[2]);
+    if (offsets[0] != 0) {
+        fmt::print(stderr, "> column {}: first offset {}\n", col, offsets[0]);
+        ++differences;
+    }
+    int64_t null_count{0};
+    for (int64_t row = 0; row < array.length; ++row) {
+        const ae::xlsx::nrow_t nrow{static_cast<size_t>(row)};
+        const bool valid = validity == nullptr || ((validity[row / 8] >> (row % 8)) & 1) != 0;
+        if (!valid)
+            ++null_count;
+        if (offsets[row + 1] < offsets[row]) {
+            fmt::print(stderr, "> column {} row {}: offsets {} {}\n", col, row, offsets[row], offsets[row + 1]);
+            ++differences;
+            continue;
+        }
+        const std::string_view cell_text{text + offsets[row], static_cast<size_t>(offsets[row + 1] - offsets[row])};
+        const auto is_empty = sheet.row(nrow).at(col).is_empty();
+        if (valid == is_empty || (!valid && !cell_text.empty()) || cell_text != sheet.text(nrow, ae::xlsx::ncol_t{col})) {
+            fmt::print(stderr, "> column {} row {}: valid {} empty {} text \"{}\" sheet \"{}\"\n", col, row, valid, is_empty, cell_text, sheet.text(nrow, ae::xlsx::ncol_t{col}));
+            ++differences;
+        }
+    }
+    if (null_count != array.null_count || (null_count == 0) != (validity == nullptr)) {
+        fmt::print(stderr, "> column {}: null_count {} counted {} validity {}\n", col, array.null_count, null_count, validity != nullptr);
+        ++differences;
+    }
+    return differences;
+
+} // check_column
+
+// ----------------------------------------------------------------------
+
+test_sheet_t::test_sheet_t(size_t rows, size_t cols)
+{
+    name_ = "arrow";
+    const std::vector<std::string> words{"LOT", "Hong Kong", "A/Hong Kong/1/2020", "<10", "1,280", "x", "\xEF\xBC\x9C" "10", "NYMC X-181", "a\tb", "line\nbreak"};
+    std::mt19937 generator{20240101};
+    std::uniform_int_distribution<size_t> kind{0, 7}, word_no{0, words.size() - 1};
+    std::uniform_int_distribution<long> number{-100, 5120};
+
+    store_.resize(ae::xlsx::nrow_t{rows}, ae::xlsx::ncol_t{cols});
+    for (ae::xlsx::nrow_t row{0}; row < ae::xlsx::nrow_t{rows}; ++row) {
+        for (ae::xlsx::ncol_t col{0}; col < ae::xlsx::ncol_t{cols}; ++col) {
+            switch (kind(generator)) {
+                case 0:
+                case 1:
+                    break; // empty
+                case 2:
+                    store_.set(row, col, number(generator));
+                    break;
+                case 3:
+                    store_.set(row, col, static_cast<double>(number(generator)) / 8.0);
+                    break;
+                case 4:
+                    store_.set(row, col, std::chrono::year{2020} / std::chrono::month{static_cast<unsigned>(*row % 12 + 1)} / 15);
+                    break;
+                default:
+                    store_.set(row, col, words[word_no(generator)]);
+                    break;
+            }
+        }
+    }
+    store_.finalize();
+
+} // test_sheet_t::test_sheet_t
+
+// ----------------------------------------------------------------------
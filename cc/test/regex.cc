@@ -0,0 +1,397 @@
+// Equivalence of ae::regex engines with std::regex (ECMAScript, icase),
+// the engine they replaced: every extractor pattern compiled at compile
+// time is run over generated cells, matches and groups must be the same.
+// Sets must report the patterns that match one by one, replacement
+// formats must expand like std::match_results::format. Run time patterns
+// (python grep) go through regex_t on every backend and must match like
+// std::regex, pike leaves syntax it does not support to std::regex.
+//
+// regex-equivalence
+//   exit code 1 if any difference is found
+
+#include <bit>
+#include <regex>
+
+#include "ext/fmt.hh"
+#include "utils/regex-backend.hh"
+#include "xlsx/sheet-extractor.hh"
+
+// ----------------------------------------------------------------------
+
+static std::vector<std::string> generate_cells(const std::vector<ae::xlsx::extractor_pattern_t>& patterns);
+static size_t static_patterns(const std::vector<ae::xlsx::extractor_pattern_t>& patterns, const std::vector<std::string>& cells);
+static size_t escapes();
+static size_t sets(const std::vector<std::string>& cells);
+static size_t formats(const std::vector<std::string>& cells);
+static size_t run_time_patterns(const std::vector<std::string>& cells);
+
+// ----------------------------------------------------------------------
+
+int main()
+{
+    const auto patterns = ae::xlsx::extractor_patterns();
+    const auto cells = generate_cells(patterns);
+    fmt::print("patterns: {} cells: {}\n", patterns.size(), cells.size());
+
+    size_t differences{0};
+    differences += static_patterns(patterns, cells);
+    differences += escapes();
+    differences += sets(cells);
+    differences += formats(cells);
+    differences += run_time_patterns(cells);
+    fmt::print("differences: {}\n", differences);
+    return differences == 0 ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------
+
+static inline std::regex std_regex(std::string_view pattern) { return std::regex{std::begin(pattern), std::end(pattern), std::regex::icase | std::regex::ECMAScript | std::regex::optimize}; }
+
+// groups of std::regex search, empty if not matched
+static inline std::vector<std::string> std_search(const std::string& cell, const std::regex& re)
+{
+    std::vector<std::string> result;
+    if (std::smatch match; std::regex_search(cell, match, re)) {
+        for (size_t group_no = 0; group_no < match.size(); ++group_no)
+            result.push_back(match[group_no].str());
+    }
+    return result;
+}
+
+static inline std::vector<std::string> groups(const ae::regex::match_t& match)
+{
+    std::vector<std::string> result;
+    for (size_t group_no = 0; group_no < match.size(); ++group_no)
+        result.push_back(match.str(group_no));
+    return result;
+}
+
+static inline size_t report(std::string_view what, std::string_view pattern, const std::string& cell, const std::vector<std::string>& expected, const std::vector<std::string>& found)
+{
+    if (expected == found)
+        return 0;
+    fmt::print(stderr, "> {} \"{}\" on \"{}\": std::regex: {} found: {}\n", what, pattern, cell, expected, found);
+    return 1;
+}
+
+// ----------------------------------------------------------------------
+
+size_t static_patterns(const std::vector<ae::xlsx::extractor_pattern_t>& patterns, const std::vector<std::string>& cells)
+{
+    size_t differences{0};
+    for (const auto& pattern : patterns) {
+        const auto re = std_regex(pattern.pattern);
+        const ae::regex::dynamic_regex dynamic{pattern.pattern};
+        for (const auto& cell : cells) {
+            const auto expected = std_search(cell, re);
+            ae::regex::match_t match;
+            differences += report(pattern.name, pattern.pattern, cell, expected, ae::regex::search(cell, match, pattern.program) ? groups(match) : std::vector<std::string>{});
+            differences += report("dynamic_regex", pattern.pattern, cell, expected, ae::regex::search(cell, match, dynamic) ? groups(match) : std::vector<std::string>{});
+
+            std::string folded(cell.size(), ' ');
+            ae::regex::fold(cell, folded.data());
+            differences += report("search_folded", pattern.pattern, cell, expected, ae::regex::search_folded(folded, cell, match, pattern.program) ? groups(match) : std::vector<std::string>{});
+        }
+    }
+    return differences;
+
+} // static_patterns
+
+// ----------------------------------------------------------------------
+
+// run time patterns: supported escapes mean what they mean for std::regex, others are rejected
+size_t escapes()
+{
+    size_t differences{0};
+    const std::vector<std::pair<std::string, std::vector<std::string>>> supported{
+        {R"(\x3C10)", {"<10", "x3C10"}},
+        {R"([\x41-\x43]+)", {"abc", "xyz"}},
+        {R"(a\tb)", {"a\tb", "atb"}},
+        {R"(\0)", {std::string{"a\0b", 3}, "0"}},
+        {R"(\-\/\.)", {"-/.", "a/b"}},
+        {R"(\bLOT\b)", {"LOT #", "PILOT"}},
+        {R"([\b])", {"\b", "b"}},
+    };
+    for (const auto& [pattern, cells] : supported) {
+        const auto re = std_regex(pattern);
+        try {
+            const ae::regex::dynamic_regex dynamic{pattern};
+            for (const auto& cell : cells) {
+                ae::regex::match_t match;
+                differences += report("escape", pattern, cell, std_search(cell, re), ae::regex::search(cell, match, dynamic) ? groups(match) : std::vector<std::string>{});
+            }
+        }
+        catch (std::invalid_argument& err) {
+            fmt::print(stderr, "> \"{}\" rejected: {}\n", pattern, err.what());
+            ++differences;
+        }
+    }
+
+    // epsilon chains as long as the program (tens of thousands of instructions)
+    for (const auto& [pattern, cell, expected] : std::vector<std::tuple<std::string, std::string, std::string>>{
+             {"(?:(?:a?){100}){100}", "aaaa", "aaaa"}, {"(?:(?:a?){100}){100}b", "xaab", "aab"}, {"^(?:(?:\\b|x?){90}){90}$", "xx", "xx"}}) {
+        try {
+            const ae::regex::dynamic_regex dynamic{pattern};
+            ae::regex::match_t match;
+            differences += report("long epsilon chain", pattern, cell, {expected}, ae::regex::search(cell, match, dynamic) ? std::vector<std::string>{match.str(0)} : std::vector<std::string>{});
+        }
+        catch (std::invalid_argument& err) {
+            fmt::print(stderr, "> \"{}\" rejected: {}\n", pattern, err.what());
+            ++differences;
+        }
+    }
+
+    for (const auto* pattern : {R"((a)\1)", R"(\A)", R"(\cJ)", R"(\p{L})", R"(\k<name>)", R"(\01)", R"(\xZZ)", R"(\c1)", R"([a-\d])", "a{70000}", "(?:a{1000}){1000}", "(?=a)a"}) {
+        try {
+            const ae::regex::dynamic_regex dynamic{pattern};
+            fmt::print(stderr, "> \"{}\" accepted, but not supported\n", pattern);
+            ++differences;
+        }
+        catch (std::invalid_argument&) {
+        }
+    }
+    return differences;
+
+} // escapes
+
+// ----------------------------------------------------------------------
+
+// labels of the CDC serum table, first matching pattern wins like in scan_replace
+static constexpr const char* set_patterns[]{R"(^\s*LOT\s*#?\s*$)", R"(SPECIES)", R"(^\s*(DATE\s*)?TREATED\s*$)", R"(\bCONTROL\b)", R"(^([AB])/([A-Z '_-]+)/([0-9]+)/([0-9]+)$)", R"(NO\s*\.\s*([\d\-]+)$)"};
+static const ae::regex::set<R"(^\s*LOT\s*#?\s*$)", R"(SPECIES)", R"(^\s*(DATE\s*)?TREATED\s*$)", R"(\bCONTROL\b)", R"(^([AB])/([A-Z '_-]+)/([0-9]+)/([0-9]+)$)", R"(NO\s*\.\s*([\d\-]+)$)"> re_set;
+
+size_t sets(const std::vector<std::string>& cells)
+{
+    std::vector<std::regex> regexes;
+    for (const auto* pattern : set_patterns)
+        regexes.push_back(std_regex(pattern));
+
+    size_t differences{0};
+    for (const auto& cell : cells) {
+        ae::regex::set_mask_t expected_mask{0};
+        std::vector<std::string> expected;
+        for (size_t pattern_no = 0; pattern_no < regexes.size(); ++pattern_no) {
+            if (auto found = std_search(cell, regexes[pattern_no]); !found.empty()) {
+                if (expected_mask == 0)
+                    expected = std::move(found);
+                expected_mask |= ae::regex::set_mask_t{1} << pattern_no;
+            }
+        }
+
+        if (const auto mask = ae::regex::search(cell, re_set); mask != expected_mask) {
+            fmt::print(stderr, "> set on \"{}\": std::regex: {:#b} found: {:#b}\n", cell, expected_mask, mask);
+            ++differences;
+        }
+        std::string folded(cell.size(), ' ');
+        ae::regex::fold(cell, folded.data());
+        if (const auto mask = ae::regex::search_folded(folded, cell, re_set); mask != expected_mask) {
+            fmt::print(stderr, "> set search_folded on \"{}\": std::regex: {:#b} found: {:#b}\n", cell, expected_mask, mask);
+            ++differences;
+        }
+
+        ae::regex::match_t match;
+        const auto pattern_no = ae::regex::search(cell, match, re_set);
+        if (pattern_no.has_value() != (expected_mask != 0) || (pattern_no.has_value() && *pattern_no != static_cast<size_t>(std::countr_zero(expected_mask)))) {
+            fmt::print(stderr, "> set search on \"{}\": std::regex: {:#b} found pattern: {}\n", cell, expected_mask, pattern_no.has_value() ? static_cast<int>(*pattern_no) : -1);
+            ++differences;
+        }
+        else if (pattern_no.has_value())
+            differences += report("set search", set_patterns[*pattern_no], cell, expected, groups(match));
+    }
+    return differences;
+
+} // sets
+
+// ----------------------------------------------------------------------
+
+size_t formats(const std::vector<std::string>& cells)
+{
+    std::vector<std::string> more_cells{cells};
+    for (const auto* cell : {"A/HONG KONG/2671/2019 x", "a/b/1/2", "EGG B/Washington/02/2019 NIID"})
+        more_cells.push_back(cell);
+
+    const auto* pattern = R"(([AB])/([A-Z '_-]+)/([0-9]+)/([0-9]+)( X)?)";
+    const auto re = std_regex(pattern);
+    const ae::regex::dynamic_regex dynamic{pattern};
+    size_t differences{0};
+    for (const auto& cell : more_cells) {
+        std::smatch expected_match;
+        ae::regex::match_t match;
+        if (!std::regex_search(cell, expected_match, re) || !ae::regex::search(cell, match, dynamic))
+            continue;
+        for (const auto* fmt : {"$1-$2", "$&", "$$1", "$0$5", "$10$11", "$05", "$9", "$99x", "[$`][$']", "$", "a$", "$x", "$3/$4 $2 ($1)"}) {
+            if (const auto expected = expected_match.format(fmt), found = match.format(fmt); expected != found) {
+                fmt::print(stderr, "> format \"{}\" on \"{}\": std::regex: \"{}\" found: \"{}\"\n", fmt, cell, expected, found);
+                ++differences;
+            }
+        }
+    }
+    return differences;
+
+} // formats
+
+// ----------------------------------------------------------------------
+
+size_t run_time_patterns(const std::vector<std::string>& cells)
+{
+    std::vector<std::string> more_cells{cells};
+    for (const auto* cell : {"<10", "x3C10", "aa", "AA", "aA", "ab", "a\tb", "a9", "LOT 12", "12 LOT", "abcdefghijkl", "xABCDEFGHIJKLx"})
+        more_cells.push_back(cell);
+
+    size_t differences{0};
+    for (const auto backend : ae::regex::available_backends()) {
+        for (const auto* pattern : {R"(\x3C10)", R"((a)\1)", R"(^(a)\1$)", R"(\x41)", R"([\x41-\x43]\d)", R"(a\tb)", R"(\bLOT\s+(\d+))", R"((?=a)a)", R"((?!LOT)\b\w+)", R"(L[O0]T)", "(a)(b)(c)(d)(e)(f)(g)(h)(i)(j)(k)(l)", "(a)(b)(c)(d)(e)(f)(g)(h)(i)(j)(k)(l)(?=x)"}) {
+            const auto re = std_regex(pattern);
+            try {
+                const ae::regex::regex_t regex{pattern, true, backend};
+                for (const auto& cell : more_cells) {
+                    const auto expected = std_search(cell, re);
+                    ae::regex::match_t match;
+                    differences += report(fmt::format("regex_t {}", ae::regex::backend_name(backend)), pattern, cell, expected, regex.search(cell, match) ? groups(match) : std::vector<std::string>{});
+                    std::string folded(cell.size(), ' ');
+                    ae::regex::fold(cell, folded.data());
+                    differences += report(fmt::format("regex_t {} search_folded", ae::regex::backend_name(backend)), pattern, cell, expected,
+                                          regex.search_folded(folded, cell, match) ? groups(match) : std::vector<std::string>{});
+                }
+            }
+            catch (std::invalid_argument& err) {
+                fmt::print(stderr, "> regex_t {} \"{}\" rejected: {}\n", ae::regex::backend_name(backend), pattern, err.what());
+                ++differences;
+            }
+        }
+    }
+
+    // the default backend accepts any ECMAScript pattern std::regex accepts
+    for (const auto* pattern : {R"((?=a)a)", R"((a)\1)", R"(\cJ)"}) {
+        try {
+            const ae::regex::regex_t regex{pattern};
+            for (const auto* cell : {"aa", "ab", "\n", "b"}) {
+                ae::regex::match_t match;
+                differences += report(fmt::format("regex_t default ({})", ae::regex::backend_name(regex.backend())), pattern, cell, std_search(cell, std_regex(pattern)),
+                                      regex.search(cell, match) ? groups(match) : std::vector<std::string>{});
+            }
+        }
+        catch (std::invalid_argument& err) {
+            fmt::print(stderr, "> regex_t \"{}\" rejected: {}\n", pattern, err.what());
+            ++differences;
+        }
+    }
+    return differences;
+
+} // run_time_patterns
+
+// ----------------------------------------------------------------------
+
+std::vector<std::string> generate_cells(const std::vector<ae::xlsx::extractor_pattern_t>& patterns)
+{
+    // cells seen in WHOCC tables
+    std::vector<std::string> cells{"",
+                                   " ",
+                                   "Lot #",
+                                   "lot",
+                                   "LOT#\n",
+                                   "Species",
+                                   "BOOSTED",
+                                   "conc",
+                                   "DILUT",
+                                   "Passage",
+                                   "POOL",
+                                   "Date treated",
+                                   "date\ntreated",
+                                   "Treated",
+                                   "BACK TITER",
+                                   "titer 1",
+                                   "HA Group",
+                                   "HA\ngroup",
+                                   "control",
+                                   "NOT CONTROL",
+                                   "controls",
+                                   "12",
+                                   "12a",
+                                   "ID",
+                                   " id ",
+                                   "serum",
+                                   "Treat.",
+                                   "TYPE",
+                                   "BATCH #",
+                                   "Comment",
+                                   "A/HONG KONG/2671/2019",
+                                   "B/Washington/02/2019",
+                                   "NYMC X-181A",
+                                   "NYMC\tX-181",
+                                   "IVR-190/SH",
+                                   "F123/19",
+                                   "SH 1,2/3",
+                                   "FERRET F12/20*1",
+                                   "F12/20*1,2",
+                                   "<=<10",
+                                   " < = <40 ",
+                                   "Superscripts 1 <=<40",
+                                   "Superscripts\n1 <=<40",
+                                   "1 <=<40; 2 <=<80",
+                                   "2 <= <20",
+                                   "2-fold",
+                                   "read",
+                                   "READ ",
+                                   "3C.2a1b A/KANSAS/14/2017 NO.123",
+                                   "A/Kansas/14/2017 No. 12-3",
+                                   "A/KANSAS\n/14/2017 NO.123",
+                                   "EGG NIID",
+                                   "cell",
+                                   "HCK\nNIID",
+                                   "A / KANSAS - 14",
+                                   "NIID-ID",
+                                   "HA group",
+                                   "SL12345678",
+                                   "VW12345678",
+                                   "VW1234567",
+                                   "Sample Date",
+                                   "sample\ndate",
+                                   "VW",
+                                   "A/Victoria/2570/2019",
+                                   "Victoria 2570",
+                                   "VICTORIA/2570_E2",
+                                   "A1234",
+                                   "F1234-14D",
+                                   "A1234-14d",
+                                   "HUMAN POOL",
+                                   "pooled human serum",
+                                   "FERRET\nHUMAN",
+                                   "WHO",
+                                   "normal",
+                                   "GOAT",
+                                   "POS VAX",
+                                   "post vax",
+                                   "POST\nVAX",
+                                   "POST\tVAX",
+                                   "LOTS"};
+
+    // literal runs of the patterns alone and in typical surroundings
+    for (const auto& pattern : patterns) {
+        for (size_t pos = 0; pos < pattern.pattern.size();) {
+            if (pattern.pattern[pos] == '\\') {
+                pos += 2;
+                continue;
+            }
+            const auto first = pos;
+            while (pos < pattern.pattern.size() && std::isalnum(static_cast<unsigned char>(pattern.pattern[pos])))
+                ++pos;
+            if (pos == first) {
+                ++pos;
+                continue;
+            }
+            const std::string run{pattern.pattern.substr(first, pos - first)};
+            std::string lower{run};
+            std::transform(std::begin(lower), std::end(lower), std::begin(lower), [](char cc) { return static_cast<char>(std::tolower(static_cast<unsigned char>(cc))); });
+            for (const auto& text : {run, lower, fmt::format(" {} ", run), fmt::format("{}\n", run), fmt::format("\t{}", lower), fmt::format("{} #", run), fmt::format("X {}", run), fmt::format("{}\nX", run),
+                                     fmt::format("A/{}/1/2020", run)})
+                cells.push_back(text);
+        }
+    }
+    std::sort(std::begin(cells), std::end(cells));
+    cells.erase(std::unique(std::begin(cells), std::end(cells)), std::end(cells));
+    return cells;
+
+} // generate_cells
+
+// ----------------------------------------------------------------------
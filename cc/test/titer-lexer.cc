@@ -0,0 +1,102 @@
+// Differential test of ae::xlsx::lex_titer against the std::regex it
+// replaced in Sheet::maybe_titer, then time of both on typical cells.
+//
+// titer-lexer [repeat]
+//   exit code 1 if lex_titer and the regex disagree on any input
+
+#include <chrono>
+#include <random>
+#include <regex>
+
+#include "ext/fmt.hh"
+#include "xlsx/titer.hh"
+
+// ----------------------------------------------------------------------
+
+// pattern used by Sheet::maybe_titer before xlsx/titer.hh
+static const std::regex re_titer{R"(^\s*(<|>|,|(?:<|>|\xEF\xBC\x9C)?\s*[1-9][0-9]{0,5}|N[DAT]|QNS|\*)\s*$)", std::regex::icase | std::regex::ECMAScript | std::regex::optimize};
+
+static std::vector<std::string> generate_inputs();
+static double milliseconds(const std::vector<std::string>& inputs, size_t repeat, bool (*recognize)(const std::string&));
+
+// ----------------------------------------------------------------------
+
+int main(int argc, char* const argv[])
+{
+    const size_t repeat = argc > 1 ? std::stoul(argv[1]) : 10;
+
+    const auto inputs = generate_inputs();
+    size_t disagreements{0}, titers{0};
+    for (const auto& input : inputs) {
+        const auto by_lexer = ae::xlsx::is_titer(input), by_regex = std::regex_search(input, re_titer);
+        if (by_lexer != by_regex) {
+            if (++disagreements <= 20)
+                fmt::print(stderr, "> \"{}\": lex_titer: {} regex: {}\n", input, by_lexer, by_regex);
+        }
+        if (by_regex)
+            ++titers;
+    }
+    fmt::print("inputs: {} titers: {} disagreements: {}\n", inputs.size(), titers, disagreements);
+
+    // typical cells of a titer table
+    const std::vector<std::string> cells{"<10", "10", "20", "40", "80", "160", "320", "640", "1280", "2560", "5120", ">5120", "*", "ND", "NT", "A/HONG KONG/1/2020", "SEQUENCE", "2020-01-01", " 40 ", "\xEF\xBC\x9C" "10"};
+    const auto lexer = milliseconds(cells, repeat * 10000, [](const std::string& input) { return ae::xlsx::is_titer(input); });
+    const auto regex = milliseconds(cells, repeat * 10000, [](const std::string& input) { return std::regex_search(input, re_titer); });
+    fmt::print("{} cells x {}: lex_titer {:.2f} ms, std::regex {:.2f} ms ({:.1f}x)\n", cells.size(), repeat * 10000, lexer, regex, lexer > 0.0 ? regex / lexer : 0.0);
+
+    return disagreements == 0 ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------
+
+std::vector<std::string> generate_inputs()
+{
+    std::vector<std::string> inputs{"",      "<",   ">",    ",",    "*",   " ,",      "< 10",    "<10",     "> 5120", "0",      "1234567", "123456", "999999", "0010", "10 0", "ND",
+                                    "nd",    "Na",  "nT",   "NX",   "QNS", "qns",     "QN",      "QNSS",    "**",     "<>10",   "<<10",    "10<",    "\t40\n", "\v80\f", "\r\n",  "\xEF\xBC\x9C",
+                                    "\xEF\xBC\x9C" "10", "\xEF\xBC\x9C 10", "\xEF\xBC" "10", "\xEF\xBC\x9D" "10", ">\xEF\xBC\x9C" "10", "1,280", "40/80", "<10 ", " <10", "-10"};
+
+    // every string up to 4 characters over the characters of the language and a few others
+    const std::string alphabet{"<>,*0159NDATQSnqx \t\xEF\xBC\x9C"};
+    std::vector<std::string> level{""};
+    for (size_t length = 1; length <= 4; ++length) {
+        std::vector<std::string> next;
+        for (const auto& prefix : level) {
+            for (const auto cc : alphabet)
+                next.push_back(prefix + cc);
+        }
+        inputs.insert(std::end(inputs), std::begin(next), std::end(next));
+        level = std::move(next);
+    }
+
+    // longer random strings, mostly digits and spaces to reach the 6 digit limit
+    std::mt19937 generator{20240101};
+    const std::string random_alphabet{"0123456789012345678901234567890123456789  <>\t\xEF\xBC\x9CNDq"};
+    std::uniform_int_distribution<size_t> length_distribution{5, 12}, char_distribution{0, random_alphabet.size() - 1};
+    for (size_t no = 0; no < 200000; ++no) {
+        std::string input(length_distribution(generator), ' ');
+        for (auto& cc : input)
+            cc = random_alphabet[char_distribution(generator)];
+        inputs.push_back(std::move(input));
+    }
+    return inputs;
+
+} // generate_inputs
+
+// ----------------------------------------------------------------------
+
+double milliseconds(const std::vector<std::string>& inputs, size_t repeat, bool (*recognize)(const std::string&))
+{
+    size_t recognized{0};
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t iteration = 0; iteration < repeat; ++iteration) {
+        for (const auto& input : inputs)
+            recognized += recognize(input) ? 1 : 0;
+    }
+    const auto result = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (recognized == 0)
+        fmt::print(stderr, "> nothing recognized\n"); // keeps the loop from being optimized away
+    return result;
+
+} // milliseconds
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,147 @@
+// Sheet::grep narrowed by the token index must find what the scan of the
+// region finds: every pattern is grepped on a generated sheet before and
+// after the token index is built, results must be the same. grep_lazy,
+// find_first and count (narrowed too) must agree with the scan as well.
+//
+// token-index
+//   exit code 1 if any difference is found
+
+#include <random>
+#include <unistd.h>
+
+#include "ext/fmt.hh"
+#include "utils/file.hh"
+#include "utils/regex-backend.hh"
+#include "xlsx/csv-parser.hh"
+#include "xlsx/cell-index.hh"
+#include "xlsx/sheet-extractor.hh"
+
+// ----------------------------------------------------------------------
+
+static std::filesystem::path write_csv();
+
+// ----------------------------------------------------------------------
+
+static inline bool same(const std::vector<ae::xlsx::cell_match_t>& found1, const std::vector<ae::xlsx::cell_match_t>& found2)
+{
+    return std::equal(std::begin(found1), std::end(found1), std::begin(found2), std::end(found2),
+                      [](const auto& cm1, const auto& cm2) { return cm1.row == cm2.row && cm1.col == cm2.col && cm1.matches == cm2.matches; });
+}
+
+// eager and lazy grep, find_first, count against the scan of the region, number of differences
+template <typename Regex> static size_t check(std::string_view name, std::string_view pattern, const ae::xlsx::Sheet& sheet, const Regex& rex, const std::pair<ae::xlsx::cell_addr_t, ae::xlsx::cell_addr_t>& region,
+                                            const std::vector<ae::xlsx::cell_match_t>& scanned)
+{
+    size_t differences{0};
+    if (const auto indexed = sheet.grep(rex, region.first, region.second); !same(indexed, scanned)) {
+        fmt::print(stderr, "> {} \"{}\": indexed: {} scanned: {}\n", name, pattern, indexed.size(), scanned.size());
+        ++differences;
+    }
+
+    std::vector<ae::xlsx::cell_match_t> lazy;
+    for (const auto& found : sheet.grep_lazy(rex, region.first, region.second))
+        lazy.push_back(found.to_match());
+    if (!same(lazy, scanned)) {
+        fmt::print(stderr, "> {} \"{}\": grep_lazy: {} scanned: {}\n", name, pattern, lazy.size(), scanned.size());
+        ++differences;
+    }
+
+    if (const auto count = sheet.count(rex, region.first, region.second); count != scanned.size()) {
+        fmt::print(stderr, "> {} \"{}\": count: {} scanned: {}\n", name, pattern, count, scanned.size());
+        ++differences;
+    }
+
+    if (const auto first = sheet.find_first(rex, region.first, region.second); first.has_value() != !scanned.empty() || (first.has_value() && !same({first->to_match()}, {scanned.front()}))) {
+        fmt::print(stderr, "> {} \"{}\": find_first differs from scan\n", name, pattern);
+        ++differences;
+    }
+    return differences;
+}
+
+int main()
+{
+    const auto filename = write_csv();
+    const ae::xlsx::csv::Sheet sheet{filename};
+    std::filesystem::remove(filename);
+
+    const std::vector<std::pair<ae::xlsx::cell_addr_t, ae::xlsx::cell_addr_t>> regions{
+        {{ae::xlsx::nrow_t{0}, ae::xlsx::ncol_t{0}}, {sheet.number_of_rows(), sheet.number_of_columns()}},
+        {{ae::xlsx::nrow_t{3}, ae::xlsx::ncol_t{1}}, {ae::xlsx::nrow_t{150}, ae::xlsx::ncol_t{5}}},
+    };
+
+    std::vector<ae::regex::regex_t> run_time;
+    for (const auto backend : ae::regex::available_backends()) {
+        for (const auto* pattern : {R"(^(lot)\s*([0-9]*)$)", "Hong Kong", "HONG\\s+KONG/([0-9]+)", "/1/", "ontro", "<10", "ECIE", "lot 12", "x$", "\\bID\\b", "No\\.\\s*([0-9]+)", "X-181",
+                                    R"(\x3C10)", R"((L)\1)", "(?=lot)lo", "L[O0]T", "a\\sb"})
+            run_time.emplace_back(pattern, true, backend);
+    }
+    const auto compile_time = ae::xlsx::extractor_patterns();
+
+    // scan of the region
+    std::vector<std::vector<ae::xlsx::cell_match_t>> scanned_run_time, scanned_compile_time;
+    for (const auto& region : regions) {
+        for (const auto& rex : run_time)
+            scanned_run_time.push_back(sheet.grep(rex, region.first, region.second));
+        for (const auto& pattern : compile_time)
+            scanned_compile_time.push_back(sheet.grep(pattern.program, region.first, region.second));
+    }
+
+    // lazy scan, then narrowed by the token index
+    size_t differences{0}, found{0};
+    for (const bool indexed : {false, true}) {
+        if (indexed)
+            sheet.token_index();
+        auto scanned_rt = std::begin(scanned_run_time);
+        auto scanned_ct = std::begin(scanned_compile_time);
+        for (const auto& region : regions) {
+            for (const auto& rex : run_time) {
+                differences += check(fmt::format("regex_t {}", ae::regex::backend_name(rex.backend())), rex.pattern(), sheet, rex, region, *scanned_rt);
+                found += indexed ? scanned_rt->size() : 0;
+                ++scanned_rt;
+            }
+            for (const auto& pattern : compile_time) {
+                differences += check(pattern.name, pattern.pattern, sheet, pattern.program, region, *scanned_ct);
+                found += indexed ? scanned_ct->size() : 0;
+                ++scanned_ct;
+            }
+        }
+    }
+
+    fmt::print("cells: {} patterns: {} found: {} differences: {}\n", *sheet.number_of_rows() * *sheet.number_of_columns(), run_time.size() + compile_time.size(), found, differences);
+    return differences == 0 ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------
+
+std::filesystem::path write_csv()
+{
+    const std::vector<std::string> words{"LOT",  "lot",    "Lot #",   "PILOT", "Hong",   "Kong", "HONG KONG", "A/Hong Kong/1/2020", "B/Washington/02/2019", "12",  "2019", "CONTROL", "controls",
+                                         "<10",  "< 10",   "<=<40",   "ID",    "id",     "IDs",  "Species",   "SPECIES",           "NYMC X-181",           "No.", "No. 123", "x",       "AB",
+                                         "a b",  "a\tb",   "Treated", "DATE",  "POOLED", "Ll",   "LL",        "HA group",          "titer",                "1",   "/1/",     "ontro",   "L0T"};
+    const std::vector<std::string> separators{" ", "/", "-", "\n", "#", ".", "", ": "};
+
+    std::mt19937 generator{20240101};
+    std::uniform_int_distribution<size_t> word_no{0, words.size() - 1}, separator_no{0, separators.size() - 1}, number_of_words{0, 3};
+    std::string csv;
+    for (size_t row = 0; row < 400; ++row) {
+        for (size_t col = 0; col < 8; ++col) {
+            if (col > 0)
+                csv.append(1, ',');
+            csv.append(1, '"');
+            for (size_t no = number_of_words(generator); no > 0; --no) {
+                csv.append(words[word_no(generator)]);
+                if (no > 1)
+                    csv.append(separators[separator_no(generator)]);
+            }
+            csv.append(1, '"');
+        }
+        csv.append(1, '\n');
+    }
+
+    const auto filename = std::filesystem::temp_directory_path() / fmt::format("token-index-{}.csv", ::getpid());
+    ae::file::write(filename, csv, ae::file::force_compression::no, ae::file::backup_file::no);
+    return filename;
+
+} // write_csv
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,430 @@
+#include <regex>
+
+#ifdef AE_REGEX_PCRE2
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+#endif
+
+#include "ext/fmt.hh"
+#include "utils/regex-backend.hh"
+
+// ----------------------------------------------------------------------
+
+namespace ae::regex::detail
+{
+    class std_regex_engine_t : public engine_t
+    {
+      public:
+        std_regex_engine_t(std::string_view pattern, bool icase)
+        try : re_{std::begin(pattern), std::end(pattern), (icase ? std::regex::icase : std::regex::flag_type{}) | std::regex::ECMAScript | std::regex::optimize} {
+        }
+        catch (std::regex_error& err) {
+            throw std::invalid_argument{err.what()};
+        }
+
+        bool execute(std::string_view input, bool full, captures_t* captures) const override
+        {
+            if (!captures)
+                return full ? std::regex_match(std::begin(input), std::end(input), re_) : std::regex_search(std::begin(input), std::end(input), re_);
+            std::match_results<std::string_view::const_iterator> match;
+            if (!(full ? std::regex_match(std::begin(input), std::end(input), match, re_) : std::regex_search(std::begin(input), std::end(input), match, re_)))
+                return false;
+            captures->resize(match.size());
+            for (size_t group_no = 0; group_no < captures->size(); ++group_no) {
+                if (match[group_no].matched)
+                    (*captures)[group_no] = input.substr(static_cast<size_t>(match.position(group_no)), static_cast<size_t>(match.length(group_no)));
+                else
+                    (*captures)[group_no] = std::string_view{};
+            }
+            return true;
+        }
+
+      private:
+        std::regex re_;
+    };
+
+    // ----------------------------------------------------------------------
+
+    class pike_engine_t : public engine_t
+    {
+      public:
+        pike_engine_t(std::string_view pattern, bool icase) : re_{pattern, icase} {}
+
+        bool execute(std::string_view input, bool full, captures_t* captures) const override
+        {
+            if (!captures)
+                return ae::regex::execute(re_, input, 0, full, nullptr);
+            match_t match;
+            if (!ae::regex::execute(re_, input, 0, full, &match))
+                return false;
+            captures->resize(match.size());
+            for (size_t group_no = 0; group_no < captures->size(); ++group_no)
+                (*captures)[group_no] = match[group_no];
+            return true;
+        }
+
+        bool execute_folded(std::string_view folded, std::string_view input, bool full, captures_t* captures) const override
+        {
+            if (!captures)
+                return ae::regex::execute_folded(re_, folded, input, full, nullptr);
+            match_t match;
+            if (!ae::regex::execute_folded(re_, folded, input, full, &match))
+                return false;
+            captures->resize(match.size());
+            for (size_t group_no = 0; group_no < captures->size(); ++group_no)
+                (*captures)[group_no] = match[group_no];
+            return true;
+        }
+
+      private:
+        dynamic_regex re_;
+    };
+
+    // ----------------------------------------------------------------------
+
+#ifdef AE_REGEX_PCRE2
+
+    class pcre2_engine_t : public engine_t
+    {
+      public:
+        // the pattern is compiled twice, PCRE2_ANCHORED and PCRE2_ENDANCHORED passed to pcre2_match would disable jit
+        pcre2_engine_t(std::string_view pattern, bool icase) : search_{compile(pattern, icase ? PCRE2_CASELESS : 0)}
+        {
+            try {
+                full_ = compile(pattern, (icase ? PCRE2_CASELESS : 0) | PCRE2_ANCHORED | PCRE2_ENDANCHORED);
+            }
+            catch (std::invalid_argument&) {
+                pcre2_code_free(search_);
+                throw;
+            }
+        }
+
+        ~pcre2_engine_t() override
+        {
+            pcre2_code_free(search_);
+            pcre2_code_free(full_);
+        }
+
+        pcre2_engine_t(const pcre2_engine_t&) = delete;
+        pcre2_engine_t& operator=(const pcre2_engine_t&) = delete;
+
+        bool execute(std::string_view input, bool full, captures_t* captures) const override
+        {
+            // match data is reused, grown when a pattern has more groups than it holds
+            thread_local std::unique_ptr<pcre2_match_data, decltype(&pcre2_match_data_free)> match_data{nullptr, &pcre2_match_data_free};
+            if (!match_data || pcre2_get_ovector_count(match_data.get()) <= group_count_)
+                match_data.reset(pcre2_match_data_create(static_cast<uint32_t>(group_count_ + 1), nullptr));
+            const auto rc = pcre2_match(full ? full_ : search_, reinterpret_cast<PCRE2_SPTR>(input.data()), input.size(), 0, 0, match_data.get(), nullptr);
+            if (rc < 0)
+                return false; // PCRE2_ERROR_NOMATCH or matching error
+            if (captures) {
+                const auto* ovector = pcre2_get_ovector_pointer(match_data.get());
+                captures->resize(group_count_ + 1);
+                for (size_t group_no = 0; group_no < captures->size(); ++group_no) {
+                    if (ovector[group_no * 2] != PCRE2_UNSET)
+                        (*captures)[group_no] = input.substr(ovector[group_no * 2], ovector[group_no * 2 + 1] - ovector[group_no * 2]);
+                    else
+                        (*captures)[group_no] = std::string_view{};
+                }
+            }
+            return true;
+        }
+
+      private:
+        pcre2_code* search_{nullptr};
+        pcre2_code* full_{nullptr};
+        size_t group_count_{0};
+
+        pcre2_code* compile(std::string_view pattern, uint32_t options)
+        {
+            int error_code{0};
+            PCRE2_SIZE error_offset{0};
+            // PCRE2_DOLLAR_ENDONLY: $ does not match before trailing newline, like ECMAScript
+            auto* code = pcre2_compile(reinterpret_cast<PCRE2_SPTR>(pattern.data()), pattern.size(), options | PCRE2_DOLLAR_ENDONLY, &error_code, &error_offset, nullptr);
+            if (code == nullptr) {
+                std::array<PCRE2_UCHAR, 256> message;
+                pcre2_get_error_message(error_code, message.data(), message.size());
+                throw std::invalid_argument{fmt::format("pcre2: {} at {} in \"{}\"", reinterpret_cast<const char*>(message.data()), error_offset, pattern)};
+            }
+            pcre2_jit_compile(code, PCRE2_JIT_COMPLETE); // interpreter is used if jit is not available
+            uint32_t capture_count{0};
+            pcre2_pattern_info(code, PCRE2_INFO_CAPTURECOUNT, &capture_count);
+            group_count_ = capture_count;
+            return code;
+        }
+    };
+
+#endif
+
+    // ----------------------------------------------------------------------
+
+    static std::shared_ptr<const engine_t> make_engine(std::string_view pattern, bool icase, backend_t backend)
+    {
+        switch (backend) {
+            case backend_t::std_regex:
+                return std::make_shared<std_regex_engine_t>(pattern, icase);
+            case backend_t::pike:
+                return std::make_shared<pike_engine_t>(pattern, icase);
+            case backend_t::pcre2:
+#ifdef AE_REGEX_PCRE2
+                return std::make_shared<pcre2_engine_t>(pattern, icase);
+#else
+                throw std::invalid_argument{"regex_t: pcre2 backend is not available in this build"};
+#endif
+        }
+        throw std::invalid_argument{"regex_t: unknown backend"};
+    }
+
+} // namespace ae::regex::detail
+
+// ----------------------------------------------------------------------
+
+ae::regex::backend_t ae::regex::default_backend()
+{
+#if defined(AE_REGEX_BACKEND_STD)
+    return backend_t::std_regex;
+#elif defined(AE_REGEX_BACKEND_PCRE2) && defined(AE_REGEX_PCRE2)
+    return backend_t::pcre2;
+#else
+    return backend_t::pike;
+#endif
+
+} // ae::regex::default_backend
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::regex::backend_t> ae::regex::available_backends()
+{
+#ifdef AE_REGEX_PCRE2
+    return {backend_t::std_regex, backend_t::pike, backend_t::pcre2};
+#else
+    return {backend_t::std_regex, backend_t::pike};
+#endif
+
+} // ae::regex::available_backends
+
+// ----------------------------------------------------------------------
+
+std::string_view ae::regex::backend_name(backend_t backend)
+{
+    switch (backend) {
+        case backend_t::std_regex:
+            return "std";
+        case backend_t::pike:
+            return "pike";
+        case backend_t::pcre2:
+            return "pcre2";
+    }
+    return "unknown";
+
+} // ae::regex::backend_name
+
+// ----------------------------------------------------------------------
+
+ae::regex::backend_t ae::regex::backend_from_name(std::string_view name)
+{
+    for (const auto backend : {backend_t::std_regex, backend_t::pike, backend_t::pcre2}) {
+        if (backend_name(backend) == name)
+            return backend;
+    }
+    throw std::invalid_argument{fmt::format("unknown regex backend \"{}\"", name)};
+
+} // ae::regex::backend_from_name
+
+// ----------------------------------------------------------------------
+
+ae::regex::regex_t::regex_t(std::string_view pattern, bool icase, backend_t backend) : pattern_{pattern}, backend_{backend}, icase_{icase}
+{
+    try {
+        engine_ = detail::make_engine(pattern, icase, backend);
+    }
+    catch (std::invalid_argument&) {
+        if (backend != backend_t::pike)
+            throw;
+        // syntax dynamic_regex does not support (lookahead, backreferences ...), std::regex matches it
+        backend_ = backend_t::std_regex;
+        engine_ = detail::make_engine(pattern, icase, backend_);
+    }
+
+    // dynamic_regex throws on any syntax it does not parse exactly (see static-regex.hh),
+    // a prefilter is therefore never derived from a misread pattern
+    try {
+        prefilter_ = dynamic_regex{pattern, icase}.program().prefilter;
+    }
+    catch (std::invalid_argument&) {
+        // pattern uses syntax not supported by dynamic_regex, e.g. lookahead, no prefilter
+    }
+
+    // pike engine prefilters itself and matches folded text as is
+    if (backend_ != backend_t::pike) {
+        if (icase) {
+            if (const auto folded = detail::fold_pattern(pattern); folded.has_value()) {
+                try {
+                    folded_engine_ = detail::make_engine(*folded, false, backend_);
+                }
+                catch (std::invalid_argument&) {
+                    // not expected, search_folded() uses engine_ on the original text then
+                }
+            }
+        }
+    }
+
+} // ae::regex::regex_t::regex_t
+
+// ----------------------------------------------------------------------
+
+bool ae::regex::regex_t::execute(std::string_view input, bool full, match_t* match) const
+{
+    if (backend_ != backend_t::pike && prefilter_.has_value() && !prefilter_->may_match(input))
+        return false;
+    if (!match)
+        return engine_->execute(input, full, nullptr);
+    detail::captures_t captures;
+    if (!engine_->execute(input, full, &captures))
+        return false;
+    match->input_ = input;
+    match->groups_ = std::move(captures);
+    return true;
+
+} // ae::regex::regex_t::execute
+
+// ----------------------------------------------------------------------
+
+bool ae::regex::regex_t::execute_folded(std::string_view folded, std::string_view input, bool full, match_t* match) const
+{
+    if (!icase_ || folded.size() != input.size())
+        return execute(input, full, match);
+    if (backend_ != backend_t::pike && prefilter_.has_value() && !prefilter_->may_match(folded, true))
+        return false;
+    detail::captures_t captures;
+    if (folded_engine_) {
+        if (!folded_engine_->execute(folded, full, match ? &captures : nullptr))
+            return false;
+        // offsets in folded are offsets in input
+        for (size_t group_no = 0; group_no < captures.size(); ++group_no) {
+            if (const auto group = captures[group_no]; group.data() != nullptr)
+                captures[group_no] = input.substr(static_cast<size_t>(group.data() - folded.data()), group.size());
+        }
+    }
+    else if (!engine_->execute_folded(folded, input, full, match ? &captures : nullptr))
+        return false;
+    if (match) {
+        match->input_ = input;
+        match->groups_ = std::move(captures);
+    }
+    return true;
+
+} // ae::regex::regex_t::execute_folded
+
+// ----------------------------------------------------------------------
+
+std::optional<std::string> ae::regex::detail::fold_pattern(std::string_view pattern)
+{
+    const auto is_lower = [](char cc) { return cc >= 'a' && cc <= 'z'; };
+    const auto is_upper = [](char cc) { return cc >= 'A' && cc <= 'Z'; };
+    const auto is_letter = [&](char cc) { return is_lower(cc) || is_upper(cc); };
+    const auto upper = [](char cc) { return static_cast<char>(to_upper(static_cast<uint8_t>(cc))); };
+    const auto is_class_escape = [](char cc) { return std::string_view{"dDsSwW"}.find(cc) != std::string_view::npos; };
+    const auto control_escape = [](char cc) -> std::optional<char> {
+        switch (cc) {
+            case 't':
+                return '\t';
+            case 'n':
+                return '\n';
+            case 'r':
+                return '\r';
+            case 'v':
+                return '\v';
+            case 'f':
+                return '\f';
+            default:
+                return std::nullopt;
+        }
+    };
+
+    // character of a class: ch is -1 for \d \s \w and their negations
+    struct atom_t
+    {
+        std::string_view source;
+        int ch{-1};
+    };
+
+    std::string result;
+    for (size_t pos = 0; pos < pattern.size(); ++pos) {
+        const auto cc = pattern[pos];
+        if (cc == '\\') {
+            if (++pos == pattern.size())
+                return std::nullopt;
+            if (const auto next = pattern[pos]; is_class_escape(next) || next == 'b' || next == 'B' || (next >= '0' && next <= '9') || control_escape(next).has_value())
+                result.append(pattern.substr(pos - 1, 2));
+            else if (is_letter(next))
+                return std::nullopt; // \x41 \u0041 \cJ \p{L} \Q etc.
+            else
+                result.append(pattern.substr(pos - 1, 2));
+        }
+        else if (cc == '(' && (pos + 1) < pattern.size() && pattern[pos + 1] == '?') {
+            if ((pos + 2) >= pattern.size() || std::string_view{":=!"}.find(pattern[pos + 2]) == std::string_view::npos)
+                return std::nullopt; // (?i) (?<name> (?<= etc.
+            result.append(pattern.substr(pos, 3));
+            pos += 2;
+        }
+        else if (cc == '[') {
+            result.append(1, '[');
+            ++pos;
+            const bool negated = pos < pattern.size() && pattern[pos] == '^';
+            if (negated)
+                result.append(1, pattern[pos++]);
+            const auto atom = [&]() -> std::optional<atom_t> {
+                if (pattern[pos] != '\\')
+                    return atom_t{pattern.substr(pos++, 1), static_cast<uint8_t>(pattern[pos - 1])};
+                if ((pos + 1) == pattern.size())
+                    return std::nullopt;
+                const auto next = pattern[pos + 1];
+                const auto source = pattern.substr(pos, 2);
+                pos += 2;
+                if (is_class_escape(next))
+                    return atom_t{source};
+                if (const auto control = control_escape(next); control.has_value())
+                    return atom_t{source, static_cast<uint8_t>(*control)};
+                if (next == 'b')
+                    return atom_t{source, '\b'};
+                if (is_letter(next) || (next >= '0' && next <= '9'))
+                    return std::nullopt;
+                return atom_t{source, static_cast<uint8_t>(next)};
+            };
+            while (pos < pattern.size() && pattern[pos] != ']') {
+                const auto first = atom();
+                if (!first.has_value())
+                    return std::nullopt;
+                if (first->ch >= 0 && (pos + 1) < pattern.size() && pattern[pos] == '-' && pattern[pos + 1] != ']') { // range
+                    ++pos;
+                    const auto last = atom();
+                    if (!last.has_value() || last->ch < first->ch)
+                        return std::nullopt;
+                    const auto lo = static_cast<char>(first->ch), hi = static_cast<char>(last->ch);
+                    if ((is_lower(lo) && is_lower(hi)) || (is_upper(lo) && is_upper(hi)))
+                        result.append({upper(lo), '-', upper(hi)});
+                    else if (((lo <= 'Z' && hi >= 'A') || (lo <= 'z' && hi >= 'a')) && !(lo <= 'A' && hi >= 'Z'))
+                        return std::nullopt; // uppercase letters not covered, e.g. [_-z]
+                    else
+                        result.append(first->source).append(1, '-').append(last->source);
+                }
+                else if (first->ch < 0)
+                    result.append(first->source);
+                else if (is_letter(static_cast<char>(first->ch)))
+                    result.append(1, upper(static_cast<char>(first->ch)));
+                else
+                    result.append(first->source);
+            }
+            if (pos == pattern.size())
+                return std::nullopt;
+            result.append(1, ']');
+        }
+        else
+            result.append(1, upper(cc));
+    }
+    return result;
+
+} // ae::regex::detail::fold_pattern
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/static-regex.hh"
+
+// ======================================================================
+// Patterns supplied at run time (python grep, scan_replace tables) are
+// matched by one of the engines below, all behind the same search/match API:
+//
+//   std_regex - std::regex, ECMAScript
+//   pike      - ae::regex::dynamic_regex, linear time, same engine as static_regex,
+//               patterns with syntax it does not support (backreferences, lookaround,
+//               \u, \p ...) are matched by std_regex, regex_t::backend() reports it
+//   pcre2     - PCRE2 with JIT, only if the library was found at build time
+//
+// Default engine is selected at build time: meson setup -Dregex_backend=std|pike|pcre2
+//
+// search_folded() matches text passed through ae::regex::fold() (sheet shadow
+// text), icase regex then runs case sensitive: pike compares folded characters
+// as is, std and pcre2 use a second engine compiled from the folded pattern.
+// ======================================================================
+
+namespace ae::regex
+{
+    enum class backend_t { std_regex, pike, pcre2 };
+
+    backend_t default_backend();
+    std::vector<backend_t> available_backends();
+    std::string_view backend_name(backend_t backend);
+    backend_t backend_from_name(std::string_view name); // throws std::invalid_argument
+
+    namespace detail
+    {
+        // groups of a match found by an engine, all groups of the pattern
+        using captures_t = groups_t;
+
+        class engine_t
+        {
+          public:
+            virtual ~engine_t() = default;
+            // full: the whole input must match
+            virtual bool execute(std::string_view input, bool full, captures_t* captures) const = 0;
+            // folded: input passed through fold(), groups refer to input
+            virtual bool execute_folded(std::string_view /*folded*/, std::string_view input, bool full, captures_t* captures) const { return execute(input, full, captures); }
+        };
+
+        // pattern matching folded text case sensitively like pattern matches the original text with icase,
+        // nullopt if pattern has syntax whose folding is not known (e.g. \x41, (?i), [_-z])
+        std::optional<std::string> fold_pattern(std::string_view pattern);
+
+    } // namespace detail
+
+    class regex_t
+    {
+      public:
+        explicit regex_t(std::string_view pattern, bool icase = true, backend_t backend = default_backend()); // throws std::invalid_argument
+
+        backend_t backend() const { return backend_; } // std_regex if pike was requested but cannot compile the pattern
+
+        std::string_view pattern() const { return pattern_; }
+        const std::optional<prefilter_t>& prefilter() const { return prefilter_; } // what every match contains, absent if the pattern uses syntax static_regex does not support
+
+        bool search(std::string_view input) const { return execute(input, false, nullptr); }
+        bool search(std::string_view input, match_t& match) const { return execute(input, false, &match); }
+        bool match(std::string_view input) const { return execute(input, true, nullptr); }
+        bool match(std::string_view input, match_t& match) const { return execute(input, true, &match); }
+
+        // folded: search_in passed through fold(), groups of match refer to search_in
+        bool search_folded(std::string_view folded, std::string_view search_in) const { return execute_folded(folded, search_in, false, nullptr); }
+        bool search_folded(std::string_view folded, std::string_view search_in, match_t& match) const { return execute_folded(folded, search_in, false, &match); }
+
+      private:
+        std::string pattern_;
+        backend_t backend_;
+        bool icase_;
+        std::optional<prefilter_t> prefilter_; // absent if the pattern uses syntax static_regex does not support, checked by the pike engine itself
+        std::shared_ptr<const detail::engine_t> engine_;
+        std::shared_ptr<const detail::engine_t> folded_engine_; // std and pcre2 with icase: case sensitive, for folded text
+
+        bool execute(std::string_view input, bool full, match_t* match) const;
+        bool execute_folded(std::string_view folded, std::string_view input, bool full, match_t* match) const;
+    };
+
+    inline bool search(std::string_view search_in, const regex_t& re) { return re.search(search_in); }
+    inline bool search(std::string_view search_in, match_t& match, const regex_t& re) { return re.search(search_in, match); }
+    inline bool match(std::string_view input, const regex_t& re) { return re.match(input); }
+    inline bool match(std::string_view input, match_t& match, const regex_t& re) { return re.match(input, match); }
+    inline bool search_folded(std::string_view folded, std::string_view search_in, const regex_t& re) { return re.search_folded(folded, search_in); }
+    inline bool search_folded(std::string_view folded, std::string_view search_in, match_t& match, const regex_t& re) { return re.search_folded(folded, search_in, match); }
+
+} // namespace ae::regex
+
+// ======================================================================
@@ -4,6 +4,7 @@
 #include <optional>
 
 #include "ext/fmt.hh"
+#include "utils/regex-backend.hh"
 
 // ======================================================================
 // Support for multiple regex and replacements, see acmacs-virus/cc/reassortant.cc
@@ -26,9 +27,10 @@ namespace ae::regex
 
     // ----------------------------------------------------------------------
 
+    // look_for is matched by the backend selected at build time, see utils/regex-backend.hh
     struct look_replace_t
     {
-        const std::regex look_for;
+        const regex_t look_for;
         std::vector<const char*> fmt;
     };
 
@@ -37,7 +39,7 @@ namespace ae::regex
     template <typename Container> scan_replace_result_t scan_replace(std::string_view source, const Container& scan_data)
     {
         for (const auto& entry : scan_data) {
-            if (std::cmatch match; std::regex_search(std::begin(source), std::end(source), match, entry.look_for)) {
+            if (match_t match; entry.look_for.search(source, match)) {
                 std::vector<std::string> result(entry.fmt.size());
                 std::transform(std::begin(entry.fmt), std::end(entry.fmt), std::begin(result), [&match](const char* fmt) { return match.format(fmt); });
                 return result;
@@ -83,4 +85,8 @@ template <> struct fmt::formatter<std::cmatch> : fmt::formatter<ae::fmt_regex_ma
 {
 };
 
+template <> struct fmt::formatter<ae::regex::match_t> : fmt::formatter<ae::fmt_regex_match_formatter<ae::regex::match_t>>
+{
+};
+
 // ----------------------------------------------------------------------
@@ -0,0 +1,595 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "utils/static-regex.hh"
+
+// ----------------------------------------------------------------------
+
+namespace ae::regex::detail
+{
+    // Pike VM threads of one input position in priority order, pc is added at most once per position
+    class thread_list_t
+    {
+      public:
+        void reset(size_t program_size, size_t number_of_slots)
+        {
+            number_of_slots_ = number_of_slots;
+            pcs_.clear();
+            if (marks_.size() < program_size)
+                marks_.resize(program_size, 0);
+            slots_.resize(program_size * number_of_slots);
+            next_generation();
+        }
+
+        void clear()
+        {
+            pcs_.clear();
+            next_generation();
+        }
+
+        bool empty() const { return pcs_.empty(); }
+        size_t size() const { return pcs_.size(); }
+        size_t pc(size_t thread_no) const { return pcs_[thread_no]; }
+        const char** slots(size_t thread_no) { return slots_.data() + thread_no * number_of_slots_; }
+
+        // returns false if pc is already in the list
+        bool mark(size_t pc)
+        {
+            if (marks_[pc] == generation_)
+                return false;
+            marks_[pc] = generation_;
+            return true;
+        }
+
+        void push(size_t pc, const char* const* slots)
+        {
+            std::copy_n(slots, number_of_slots_, this->slots(pcs_.size()));
+            pcs_.push_back(pc);
+        }
+
+      private:
+        size_t number_of_slots_{0};
+        std::vector<size_t> pcs_{};
+        std::vector<const char*> slots_{};
+        std::vector<uint32_t> marks_{};
+        uint32_t generation_{0};
+
+        void next_generation()
+        {
+            if (++generation_ == 0) { // wrapped around
+                std::fill(marks_.begin(), marks_.end(), 0);
+                generation_ = 1;
+            }
+        }
+    };
+
+    class vm_t
+    {
+      public:
+        // buffers are kept between runs, allocation happens only when a bigger program is run
+        // folded: input was passed through fold(), icase program compares it as is
+        void prepare(const program_ref_t& program, std::string_view input, bool folded = false)
+        {
+            program_ = &program;
+            input_ = input;
+            folded_ = folded;
+            number_of_slots_ = (program.number_of_groups + 1) * 2;
+            current_.reset(program.code.size(), number_of_slots_);
+            next_.reset(program.code.size(), number_of_slots_);
+            slots_.assign(number_of_slots_, nullptr);
+            matched_slots_.assign(number_of_slots_, nullptr);
+        }
+
+        bool run(size_t start, bool full)
+        {
+            const char* const begin = input_.data() + start;
+            const char* const end = input_.data() + input_.size();
+            // ^ at the pattern start: threads started after the first position cannot match
+            const bool anchored = full || (program_->code.size() > 1 && program_->code[1].op == op_t::bol);
+            bool matched{false};
+            for (const char* pos = begin;; ++pos) {
+                if (!matched && (!anchored || pos == begin)) {
+                    // new thread at each position, lowest priority: leftmost match wins
+                    std::fill(slots_.begin(), slots_.end(), nullptr);
+                    add(current_, 0, pos);
+                }
+                if (current_.empty() && (matched || anchored))
+                    break;
+                for (size_t thread_no = 0; thread_no < current_.size(); ++thread_no) {
+                    const auto pc = current_.pc(thread_no);
+                    const auto& inst = program_->code[pc];
+                    if (inst.op == op_t::match) {
+                        if (!full || pos == end) {
+                            matched = true;
+                            std::copy_n(current_.slots(thread_no), number_of_slots_, matched_slots_.begin());
+                            break; // lower priority threads are cut
+                        }
+                    }
+                    else if (step(inst, pos, end)) {
+                        std::copy_n(current_.slots(thread_no), number_of_slots_, slots_.begin());
+                        add(next_, pc + 1, pos + 1);
+                    }
+                }
+                std::swap(current_, next_);
+                next_.clear();
+                if (pos == end)
+                    break;
+            }
+            return matched;
+        }
+
+        // all patterns of a set, threads are never cut, stops when every pattern matched
+        set_mask_t run_set(size_t number_of_patterns)
+        {
+            const set_mask_t all = number_of_patterns == sizeof(set_mask_t) * 8 ? ~set_mask_t{0} : ((set_mask_t{1} << number_of_patterns) - 1);
+            const char* const end = input_.data() + input_.size();
+            set_mask_t matched{0};
+            for (const char* pos = input_.data(); matched != all; ++pos) {
+                std::fill(slots_.begin(), slots_.end(), nullptr);
+                add(current_, 0, pos);
+                for (size_t thread_no = 0; thread_no < current_.size(); ++thread_no) {
+                    const auto pc = current_.pc(thread_no);
+                    const auto& inst = program_->code[pc];
+                    if (inst.op == op_t::match)
+                        matched |= set_mask_t{1} << inst.arg1;
+                    else if (step(inst, pos, end)) {
+                        std::copy_n(current_.slots(thread_no), number_of_slots_, slots_.begin());
+                        add(next_, pc + 1, pos + 1);
+                    }
+                }
+                std::swap(current_, next_);
+                next_.clear();
+                if (pos == end)
+                    break;
+            }
+            return matched;
+        }
+
+        std::string_view group(size_t group_no) const
+        {
+            if (const auto* first = matched_slots_[group_no * 2], *last = matched_slots_[group_no * 2 + 1]; first != nullptr && last != nullptr)
+                return std::string_view(first, static_cast<size_t>(last - first));
+            else
+                return {};
+        }
+
+      private:
+        const program_ref_t* program_{nullptr};
+        std::string_view input_{};
+        bool folded_{false};
+        size_t number_of_slots_{0};
+        thread_list_t current_{};
+        thread_list_t next_{};
+        std::vector<const char*> slots_{}; // of the thread being added
+        std::vector<const char*> matched_slots_{};
+
+        // pending work of add(): pc to follow, or slot to restore when the thread saved into it is done
+        struct work_t
+        {
+            static constexpr const size_t no_slot{std::numeric_limits<size_t>::max()};
+            size_t pc;
+            size_t slot;
+            const char* saved;
+        };
+        std::vector<work_t> work_{};
+
+        // consuming instruction accepts character at pos
+        bool step(const inst_t& inst, const char* pos, const char* end) const
+        {
+            if (pos == end)
+                return false;
+            switch (inst.op) {
+                case op_t::character:
+                    return compared(*pos) == inst.ch;
+                case op_t::any:
+                    if (const auto cc = compared(*pos); cc != '\n' && cc != '\r')
+                        return true;
+                    return false;
+                case op_t::char_class:
+                    return program_->classes[inst.arg1].test(static_cast<uint8_t>(*pos));
+                case op_t::match:
+                case op_t::bol:
+                case op_t::eol:
+                case op_t::word_boundary:
+                case op_t::not_word_boundary:
+                case op_t::split:
+                case op_t::jump:
+                case op_t::save:
+                    break; // followed by add()
+            }
+            return false;
+        }
+
+        uint8_t compared(char cc) const { return (program_->icase && !folded_) ? fold(static_cast<uint8_t>(cc)) : static_cast<uint8_t>(cc); }
+
+        bool word_before(const char* pos) const { return pos != input_.data() && is_word(static_cast<uint8_t>(pos[-1])); }
+        bool word_at(const char* pos) const { return pos != input_.data() + input_.size() && is_word(static_cast<uint8_t>(*pos)); }
+
+        // follows jumps, splits, saves and assertions, threads are added in priority order;
+        // explicit stack instead of recursion: epsilon chains of big run time programs
+        // (e.g. (?:(?:a?){100}){100}) are as long as the program
+        void add(thread_list_t& list, size_t start_pc, const char* pos)
+        {
+            constexpr const size_t none{std::numeric_limits<size_t>::max()};
+            work_.clear();
+            work_.push_back(work_t{.pc = start_pc, .slot = work_t::no_slot, .saved = nullptr});
+            while (!work_.empty()) {
+                const auto work = work_.back();
+                work_.pop_back();
+                if (work.slot != work_t::no_slot) {
+                    slots_[work.slot] = work.saved;
+                    continue;
+                }
+                // first branch is followed in place, second one waits on the stack
+                for (size_t pc = work.pc; pc != none && list.mark(pc);) {
+                    const auto& inst = program_->code[pc];
+                    switch (inst.op) {
+                        case op_t::jump:
+                            pc = inst.arg1;
+                            break;
+                        case op_t::split:
+                            work_.push_back(work_t{.pc = inst.arg2, .slot = work_t::no_slot, .saved = nullptr});
+                            pc = inst.arg1;
+                            break;
+                        case op_t::save:
+                            // restored after everything reached from here is added, before the pending branches
+                            work_.push_back(work_t{.pc = 0, .slot = inst.arg1, .saved = slots_[inst.arg1]});
+                            slots_[inst.arg1] = pos;
+                            ++pc;
+                            break;
+                        case op_t::bol:
+                            pc = pos == input_.data() ? pc + 1 : none;
+                            break;
+                        case op_t::eol:
+                            pc = pos == input_.data() + input_.size() ? pc + 1 : none;
+                            break;
+                        case op_t::word_boundary:
+                            pc = word_before(pos) != word_at(pos) ? pc + 1 : none;
+                            break;
+                        case op_t::not_word_boundary:
+                            pc = word_before(pos) == word_at(pos) ? pc + 1 : none;
+                            break;
+                        case op_t::character:
+                        case op_t::any:
+                        case op_t::char_class:
+                        case op_t::match:
+                            list.push(pc, slots_.data());
+                            pc = none;
+                            break;
+                    }
+                }
+            }
+        }
+    };
+
+} // namespace ae::regex::detail
+
+// ----------------------------------------------------------------------
+
+namespace ae::regex::detail
+{
+    // Prefilter counters of one thread, written by that thread only: the hot path does
+    // no read-modify-write on a cache line shared with other threads (grep on the pool).
+    // Atomic for prefilter_statistics() reading them from another thread, relaxed:
+    // counters are statistics only, ordering with other memory is irrelevant.
+    struct alignas(64) prefilter_counters_t
+    {
+        std::atomic<size_t> tested{0};
+        std::atomic<size_t> skipped{0};
+
+        static void increment(std::atomic<size_t>& counter) { counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+    };
+
+    // counters of live threads, totals of exited ones, totals at the last reset
+    class prefilter_registry_t
+    {
+      public:
+        void add(const prefilter_counters_t* counters)
+        {
+            const std::lock_guard lock{mutex_};
+            threads_.push_back(counters);
+        }
+
+        void remove(const prefilter_counters_t* counters)
+        {
+            const std::lock_guard lock{mutex_};
+            exited_.tested += counters->tested.load(std::memory_order_relaxed);
+            exited_.skipped += counters->skipped.load(std::memory_order_relaxed);
+            threads_.erase(std::find(std::begin(threads_), std::end(threads_), counters));
+        }
+
+        prefilter_statistics_t statistics() const
+        {
+            const std::lock_guard lock{mutex_};
+            const auto total = total_unlocked();
+            return {.tested = total.tested - reset_.tested, .skipped = total.skipped - reset_.skipped};
+        }
+
+        // counters are not written by other threads, the totals at reset are subtracted instead
+        void reset()
+        {
+            const std::lock_guard lock{mutex_};
+            reset_ = total_unlocked();
+        }
+
+      private:
+        mutable std::mutex mutex_{};
+        std::vector<const prefilter_counters_t*> threads_{};
+        prefilter_statistics_t exited_{};
+        prefilter_statistics_t reset_{};
+
+        prefilter_statistics_t total_unlocked() const
+        {
+            auto total = exited_;
+            for (const auto* counters : threads_) {
+                total.tested += counters->tested.load(std::memory_order_relaxed);
+                total.skipped += counters->skipped.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+    };
+
+    // never destroyed: threads may exit after static destruction started
+    inline prefilter_registry_t& prefilter_registry()
+    {
+        static auto* registry = new prefilter_registry_t;
+        return *registry;
+    }
+
+    struct thread_prefilter_counters_t
+    {
+        prefilter_counters_t counters{};
+
+        thread_prefilter_counters_t() { prefilter_registry().add(&counters); }
+        ~thread_prefilter_counters_t() { prefilter_registry().remove(&counters); }
+        thread_prefilter_counters_t(const thread_prefilter_counters_t&) = delete;
+        thread_prefilter_counters_t& operator=(const thread_prefilter_counters_t&) = delete;
+    };
+
+    inline prefilter_counters_t& prefilter_counters()
+    {
+        thread_local thread_prefilter_counters_t counters;
+        return counters.counters;
+    }
+
+    // position of the first character of input folding to cc if icase, equal to cc otherwise, npos if not found
+    inline size_t find_char(std::string_view input, size_t from, char cc, bool icase)
+    {
+        const auto find = [input, from](char look_for) -> size_t {
+            if (const void* found = std::memchr(input.data() + from, look_for, input.size() - from); found != nullptr)
+                return static_cast<size_t>(static_cast<const char*>(found) - input.data());
+            return std::string_view::npos;
+        };
+        if (!icase)
+            return find(cc);
+        const auto upper = find(cc);
+        if (const auto lower_cc = static_cast<char>(to_lower(static_cast<uint8_t>(cc))); lower_cc != cc)
+            return std::min(upper, find(lower_cc));
+        return upper;
+    }
+
+} // namespace ae::regex::detail
+
+// ----------------------------------------------------------------------
+
+bool ae::regex::prefilter_t::may_match(std::string_view input, bool folded) const
+{
+    auto& counters = detail::prefilter_counters();
+    detail::prefilter_counters_t::increment(counters.tested);
+    const bool fold_input = icase && !folded;
+    const auto pass = [&]() {
+        if (input.size() < min_length)
+            return false;
+        if (literal_size == 0)
+            return true;
+        // memchr for the first character of the literal, then compare the rest
+        for (size_t pos = 0; (pos + literal_size) <= input.size(); ++pos) {
+            if (pos = detail::find_char(input, pos, literal[0], fold_input); pos == std::string_view::npos || (pos + literal_size) > input.size())
+                return false;
+            size_t matched{1};
+            while (matched < literal_size && (fold_input ? detail::fold(static_cast<uint8_t>(input[pos + matched])) : static_cast<uint8_t>(input[pos + matched])) == static_cast<uint8_t>(literal[matched]))
+                ++matched;
+            if (matched == literal_size)
+                return true;
+        }
+        return false;
+    }();
+    if (!pass)
+        detail::prefilter_counters_t::increment(counters.skipped);
+    return pass;
+
+} // ae::regex::prefilter_t::may_match
+
+// ----------------------------------------------------------------------
+
+ae::regex::prefilter_statistics_t ae::regex::prefilter_statistics()
+{
+    return detail::prefilter_registry().statistics();
+
+} // ae::regex::prefilter_statistics
+
+// ----------------------------------------------------------------------
+
+void ae::regex::reset_prefilter_statistics()
+{
+    detail::prefilter_registry().reset();
+
+} // ae::regex::reset_prefilter_statistics
+
+// ----------------------------------------------------------------------
+
+bool ae::regex::execute(const program_ref_t& program, std::string_view input, size_t start, bool full, match_t* match)
+{
+    if (start > input.size() || !program.prefilter.may_match(input.substr(start)))
+        return false;
+
+    thread_local detail::vm_t vm;
+    vm.prepare(program, input);
+    if (!vm.run(start, full))
+        return false;
+    if (match) {
+        match->input_ = input;
+        match->groups_.resize(program.number_of_groups + 1);
+        for (size_t group_no = 0; group_no < match->groups_.size(); ++group_no)
+            match->groups_[group_no] = vm.group(group_no);
+    }
+    return true;
+
+} // ae::regex::execute
+
+// ----------------------------------------------------------------------
+
+void ae::regex::fold(std::string_view source, char* target)
+{
+    // branchless, compilers vectorize it
+    for (size_t pos = 0; pos < source.size(); ++pos) {
+        const auto cc = static_cast<uint8_t>(source[pos]);
+        target[pos] = static_cast<char>(cc - ((static_cast<uint8_t>(cc - 'a') < 26) ? 0x20 : 0));
+    }
+
+} // ae::regex::fold
+
+// ----------------------------------------------------------------------
+
+bool ae::regex::execute_folded(const program_ref_t& program, std::string_view folded, std::string_view input, bool full, match_t* match)
+{
+    if (!program.icase || folded.size() != input.size())
+        return execute(program, input, 0, full, match);
+    if (!program.prefilter.may_match(folded, true))
+        return false;
+
+    thread_local detail::vm_t vm;
+    vm.prepare(program, folded, true);
+    if (!vm.run(0, full))
+        return false;
+    if (match) {
+        match->input_ = input;
+        match->groups_.resize(program.number_of_groups + 1);
+        for (size_t group_no = 0; group_no < match->groups_.size(); ++group_no) {
+            // offsets in folded are offsets in input
+            if (const auto group = vm.group(group_no); group.data() != nullptr)
+                match->groups_[group_no] = input.substr(static_cast<size_t>(group.data() - folded.data()), group.size());
+            else
+                match->groups_[group_no] = std::string_view{};
+        }
+    }
+    return true;
+
+} // ae::regex::execute_folded
+
+// ----------------------------------------------------------------------
+
+ae::regex::dynamic_regex::dynamic_regex(std::string_view pattern, bool icase) : pattern_{pattern}, icase_{icase}
+{
+    if (pattern.size() >= max_pattern_size)
+        throw std::invalid_argument{"dynamic_regex: pattern too long"};
+    const auto parsed = detail::parser_t<max_pattern_size>{pattern, icase}.parse();
+    code_ = detail::generator_t<std::vector<detail::inst_t>, max_pattern_size>{parsed, std::vector<detail::inst_t>(detail::code_size(parsed))}.generate();
+    classes_.assign(parsed.classes.begin(), std::next(parsed.classes.begin(), static_cast<ssize_t>(parsed.number_of_classes)));
+    number_of_groups_ = parsed.number_of_groups;
+    prefilter_ = detail::make_prefilter(parsed);
+
+} // ae::regex::dynamic_regex::dynamic_regex
+
+// ----------------------------------------------------------------------
+
+ae::regex::set_mask_t ae::regex::execute(const set_ref_t& set, std::string_view search_in)
+{
+    if (!set.program.prefilter.may_match(search_in))
+        return 0;
+
+    thread_local detail::vm_t vm;
+    vm.prepare(set.program, search_in);
+    return vm.run_set(set.size());
+
+} // ae::regex::execute
+
+// ----------------------------------------------------------------------
+
+ae::regex::set_mask_t ae::regex::execute_folded(const set_ref_t& set, std::string_view folded, std::string_view search_in)
+{
+    if (!set.program.icase || folded.size() != search_in.size())
+        return execute(set, search_in);
+    if (!set.program.prefilter.may_match(folded, true))
+        return 0;
+
+    thread_local detail::vm_t vm;
+    vm.prepare(set.program, folded, true);
+    return vm.run_set(set.size());
+
+} // ae::regex::execute_folded
+
+// ----------------------------------------------------------------------
+
+std::string ae::regex::match_t::format(std::string_view fmt) const
+{
+    std::string result;
+    for (size_t pos = 0; pos < fmt.size(); ++pos) {
+        if (fmt[pos] == '$' && (pos + 1) < fmt.size()) {
+            if (const auto next = fmt[pos + 1]; detail::is_digit(static_cast<uint8_t>(next))) {
+                // $n or $nn, group not in the pattern is replaced with nothing
+                auto group_no = static_cast<size_t>(next - '0');
+                ++pos;
+                if ((pos + 1) < fmt.size() && detail::is_digit(static_cast<uint8_t>(fmt[pos + 1]))) {
+                    group_no = group_no * 10 + static_cast<size_t>(fmt[pos + 1] - '0');
+                    ++pos;
+                }
+                result.append((*this)[group_no]);
+                continue;
+            }
+            else if (next == '&') {
+                result.append((*this)[0]);
+                ++pos;
+                continue;
+            }
+            else if (next == '`') {
+                result.append(prefix());
+                ++pos;
+                continue;
+            }
+            else if (next == '\'') {
+                result.append(suffix());
+                ++pos;
+                continue;
+            }
+            else if (next == '$') {
+                result.append(1, '$');
+                ++pos;
+                continue;
+            }
+        }
+        result.append(1, fmt[pos]);
+    }
+    return result;
+
+} // ae::regex::match_t::format
+
+// ----------------------------------------------------------------------
+
+std::string ae::regex::replace(std::string_view source, const program_ref_t& program, std::string_view fmt)
+{
+    std::string result;
+    size_t start{0};
+    match_t match;
+    while (start <= source.size() && execute(program, source, start, false, &match)) {
+        const auto found = match.position(0);
+        result.append(source.substr(start, found - start));
+        result.append(match.format(fmt));
+        start = found + match[0].size();
+        if (match[0].empty()) { // avoid looping on empty match
+            if (start < source.size())
+                result.append(1, source[start]);
+            ++start;
+        }
+    }
+    if (start < source.size())
+        result.append(source.substr(start));
+    return result;
+
+} // ae::regex::replace
+
+// ----------------------------------------------------------------------
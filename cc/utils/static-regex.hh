@@ -0,0 +1,1037 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// ======================================================================
+// Regular expressions compiled at compile time
+//
+// Subset of ECMAScript: literals, ., [classes] with ranges and negation,
+// \s \S \d \D \w \W \b \B, \n \t \r \f \v \0 \xNN, ^ $ (no multiline),
+// (groups), (?:groups), |, * + ? {n} {n,} {n,m} and their lazy forms.
+// Other letter and digit escapes (backreferences, \uNNNN, \p, \k, \c) and
+// lookaround are syntax errors, never silently taken as something else.
+//
+// icase patterns compare folded characters (see fold() below): ASCII case
+// is ignored, everything else is compared as is. Text folded in advance
+// (sheet shadow text) is matched without folding each character, see
+// search_folded().
+//
+// Pattern is parsed and turned into a program for a Pike VM during
+// compilation, program size is exact. Matching is leftmost-first like
+// ECMAScript, runs in O(input * program) without backtracking.
+// Minimal match length and a literal every match contains are derived
+// from the pattern too, input failing them is rejected without running the program.
+//
+//   static constexpr ae::regex::static_regex<"^\\s*DATE\\s*$"> re_date;
+//   if (ae::regex::search(text, re_date)) ...
+//
+// Patterns supplied at run time: dynamic_regex below and utils/regex-backend.hh
+// ======================================================================
+
+namespace ae::regex
+{
+    template <size_t N> struct fixed_string
+    {
+        static constexpr const size_t capacity{N};
+
+        char data[N]{};
+
+        constexpr fixed_string(const char (&src)[N]) { std::copy_n(src, N, data); }
+        constexpr std::string_view view() const { return {data, N - 1}; }
+    };
+
+    // ----------------------------------------------------------------------
+
+    // Cheap test done before running the program: input shorter than any
+    // match or not containing the literal every match contains is skipped.
+    // Derived from the pattern during compilation.
+    struct prefilter_t
+    {
+        static constexpr const size_t max_literal{16};
+
+        std::array<char, max_literal> literal{}; // folded if icase
+        size_t literal_size{0};
+        size_t min_length{0};
+        bool icase{false};
+
+        constexpr std::string_view required() const { return {literal.data(), literal_size}; }
+        // folded: input was passed through fold(), icase prefilters only
+        bool may_match(std::string_view input, bool folded = false) const;
+    };
+
+    // number of inputs tested by prefilters and how many of them were rejected without running a program,
+    // summed over per thread counters (prefiltering does not write memory shared between threads)
+    struct prefilter_statistics_t
+    {
+        size_t tested{0};
+        size_t skipped{0};
+    };
+
+    prefilter_statistics_t prefilter_statistics();
+    void reset_prefilter_statistics();
+
+    // ----------------------------------------------------------------------
+
+    namespace detail
+    {
+        enum class op_t : uint8_t { character, any, char_class, bol, eol, word_boundary, not_word_boundary, split, jump, save, match };
+
+        struct inst_t
+        {
+            op_t op{op_t::match};
+            uint8_t ch{0};      // character
+            uint16_t arg1{0};   // char_class: class index, split: preferred target, jump: target, save: slot
+            uint16_t arg2{0};   // split: alternative target
+        };
+
+        constexpr bool is_space(uint8_t cc) { return cc == ' ' || cc == '\t' || cc == '\n' || cc == '\v' || cc == '\f' || cc == '\r'; }
+        constexpr bool is_digit(uint8_t cc) { return cc >= '0' && cc <= '9'; }
+        constexpr bool is_letter(uint8_t cc) { return (cc >= 'A' && cc <= 'Z') || (cc >= 'a' && cc <= 'z'); }
+        constexpr bool is_word(uint8_t cc) { return is_digit(cc) || (cc >= 'A' && cc <= 'Z') || (cc >= 'a' && cc <= 'z') || cc == '_'; }
+        constexpr uint8_t to_lower(uint8_t cc) { return (cc >= 'A' && cc <= 'Z') ? static_cast<uint8_t>(cc - 'A' + 'a') : cc; }
+        constexpr uint8_t to_upper(uint8_t cc) { return (cc >= 'a' && cc <= 'z') ? static_cast<uint8_t>(cc - 'a' + 'A') : cc; }
+        // icase comparison: uppercase, one byte to one byte
+        constexpr uint8_t fold(uint8_t cc) { return to_upper(cc); }
+
+        struct char_class_t
+        {
+            std::array<uint64_t, 4> bits{};
+
+            constexpr bool test(uint8_t cc) const { return (bits[cc / 64] & (uint64_t{1} << (cc % 64))) != 0; }
+            constexpr void set(uint8_t cc) { bits[cc / 64] |= uint64_t{1} << (cc % 64); }
+
+            constexpr void set(uint8_t first, uint8_t last)
+            {
+                for (unsigned cc = first; cc <= last; ++cc)
+                    set(static_cast<uint8_t>(cc));
+            }
+
+            template <typename Pred> constexpr void set_if(Pred pred, bool negate)
+            {
+                for (unsigned cc = 0; cc < 256; ++cc) {
+                    if (pred(static_cast<uint8_t>(cc)) != negate)
+                        set(static_cast<uint8_t>(cc));
+                }
+            }
+
+            constexpr void negate()
+            {
+                for (auto& word : bits)
+                    word = ~word;
+            }
+
+            // characters folding to the same one are all in the class or all out
+            constexpr void fold_case()
+            {
+                for (unsigned cc = 0; cc < 256; ++cc) {
+                    if (test(static_cast<uint8_t>(cc)))
+                        set(fold(static_cast<uint8_t>(cc)));
+                }
+                for (unsigned cc = 0; cc < 256; ++cc) {
+                    if (test(fold(static_cast<uint8_t>(cc))))
+                        set(static_cast<uint8_t>(cc));
+                }
+            }
+        };
+
+        // ----------------------------------------------------------------------
+
+        enum class node_kind_t : uint8_t { empty, character, any, char_class, bol, eol, word_boundary, not_word_boundary, group, concat, alternate, repeat };
+
+        constexpr const uint16_t no_node{0xFFFF};
+        constexpr const size_t max_code_size{0xFFFF}; // jump targets and class numbers are uint16_t
+        constexpr const uint16_t unbounded{0xFFFF};
+
+        struct node_t
+        {
+            node_kind_t kind{node_kind_t::empty};
+            uint8_t ch{0};
+            uint16_t arg{0}; // char_class: class index, group: group number
+            uint16_t left{no_node};
+            uint16_t right{no_node};
+            uint16_t min{0};
+            uint16_t max{0};
+            bool greedy{true};
+        };
+
+        template <size_t N> struct parsed_t
+        {
+            std::array<node_t, 2 * N + 4> nodes{};
+            size_t number_of_nodes{0};
+            std::array<char_class_t, N> classes{};
+            size_t number_of_classes{0};
+            size_t number_of_groups{0}; // capturing groups, whole match is not counted
+            uint16_t root{no_node};
+            bool icase{false};
+        };
+
+        // throwing makes the expression non-constant: compilation fails and points here
+        inline void syntax_error(const char* message) { throw std::invalid_argument{message}; }
+
+        template <size_t N> class parser_t
+        {
+          public:
+            constexpr parser_t(std::string_view pattern, bool icase) : pattern_{pattern} { parsed_.icase = icase; }
+
+            constexpr parsed_t<N> parse()
+            {
+                parsed_.root = alternation();
+                if (pos_ != pattern_.size())
+                    syntax_error("static_regex: unmatched )");
+                return parsed_;
+            }
+
+          private:
+            std::string_view pattern_;
+            size_t pos_{0};
+            parsed_t<N> parsed_{};
+
+            constexpr bool at_end() const { return pos_ >= pattern_.size(); }
+            constexpr char peek() const { return pattern_[pos_]; }
+
+            constexpr uint16_t add(const node_t& node)
+            {
+                if (parsed_.number_of_nodes == parsed_.nodes.size())
+                    syntax_error("static_regex: too many nodes");
+                parsed_.nodes[parsed_.number_of_nodes] = node;
+                return static_cast<uint16_t>(parsed_.number_of_nodes++);
+            }
+
+            constexpr uint16_t add(char_class_t cls)
+            {
+                if (parsed_.number_of_classes == parsed_.classes.size())
+                    syntax_error("static_regex: too many classes");
+                if (parsed_.icase)
+                    cls.fold_case();
+                parsed_.classes[parsed_.number_of_classes] = cls;
+                return add(node_t{.kind = node_kind_t::char_class, .arg = static_cast<uint16_t>(parsed_.number_of_classes++)});
+            }
+
+            constexpr uint16_t alternation()
+            {
+                auto left = concatenation();
+                while (!at_end() && peek() == '|') {
+                    ++pos_;
+                    const auto right = concatenation();
+                    left = add(node_t{.kind = node_kind_t::alternate, .left = left, .right = right});
+                }
+                return left;
+            }
+
+            constexpr uint16_t concatenation()
+            {
+                auto result = no_node;
+                while (!at_end() && peek() != '|' && peek() != ')') {
+                    const auto item = repetition();
+                    result = result == no_node ? item : add(node_t{.kind = node_kind_t::concat, .left = result, .right = item});
+                }
+                return result == no_node ? add(node_t{.kind = node_kind_t::empty}) : result;
+            }
+
+            constexpr uint16_t number()
+            {
+                if (at_end() || !is_digit(static_cast<uint8_t>(peek())))
+                    syntax_error("static_regex: number expected in {}");
+                unsigned result{0};
+                while (!at_end() && is_digit(static_cast<uint8_t>(peek()))) {
+                    result = result * 10 + static_cast<unsigned>(peek() - '0');
+                    if (result >= unbounded)
+                        syntax_error("static_regex: repetition count too big");
+                    ++pos_;
+                }
+                return static_cast<uint16_t>(result);
+            }
+
+            constexpr uint16_t repetition()
+            {
+                const auto item = atom();
+                if (at_end())
+                    return item;
+                node_t node{.kind = node_kind_t::repeat, .left = item};
+                switch (peek()) {
+                    case '*':
+                        node.min = 0;
+                        node.max = unbounded;
+                        break;
+                    case '+':
+                        node.min = 1;
+                        node.max = unbounded;
+                        break;
+                    case '?':
+                        node.min = 0;
+                        node.max = 1;
+                        break;
+                    case '{':
+                        ++pos_;
+                        node.min = node.max = number();
+                        if (!at_end() && peek() == ',') {
+                            ++pos_;
+                            node.max = (!at_end() && peek() == '}') ? unbounded : number();
+                        }
+                        if (at_end() || peek() != '}')
+                            syntax_error("static_regex: } expected");
+                        if (node.max < node.min)
+                            syntax_error("static_regex: invalid {min,max}");
+                        break;
+                    default:
+                        return item;
+                }
+                ++pos_;
+                if (!at_end() && peek() == '?') {
+                    node.greedy = false;
+                    ++pos_;
+                }
+                return add(node);
+            }
+
+            constexpr uint16_t character(uint8_t cc) { return add(node_t{.kind = node_kind_t::character, .ch = parsed_.icase ? fold(cc) : cc}); }
+
+            constexpr uint16_t atom()
+            {
+                const auto cc = static_cast<uint8_t>(peek());
+                ++pos_;
+                switch (cc) {
+                    case '(':
+                        if (pattern_.substr(pos_, 2) == "?:") {
+                            pos_ += 2;
+                            const auto child = alternation();
+                            expect_close();
+                            return child;
+                        }
+                        else {
+                            const auto group = static_cast<uint16_t>(++parsed_.number_of_groups);
+                            const auto child = alternation();
+                            expect_close();
+                            return add(node_t{.kind = node_kind_t::group, .arg = group, .left = child});
+                        }
+                    case '[':
+                        return add(bracket());
+                    case '.':
+                        return add(node_t{.kind = node_kind_t::any});
+                    case '^':
+                        return add(node_t{.kind = node_kind_t::bol});
+                    case '$':
+                        return add(node_t{.kind = node_kind_t::eol});
+                    case '*':
+                    case '+':
+                    case '?':
+                        syntax_error("static_regex: nothing to repeat");
+                        return no_node;
+                    case '\\':
+                        return escape();
+                    default:
+                        return character(cc);
+                }
+            }
+
+            constexpr void expect_close()
+            {
+                if (at_end() || peek() != ')')
+                    syntax_error("static_regex: ) expected");
+                ++pos_;
+            }
+
+            // \s \S \d \D \w \W, returns false if cc is not a class escape
+            static constexpr bool class_escape(uint8_t cc, char_class_t& cls)
+            {
+                switch (cc) {
+                    case 's':
+                    case 'S':
+                        cls.set_if(is_space, cc == 'S');
+                        return true;
+                    case 'd':
+                    case 'D':
+                        cls.set_if(is_digit, cc == 'D');
+                        return true;
+                    case 'w':
+                    case 'W':
+                        cls.set_if(is_word, cc == 'W');
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+
+            constexpr uint8_t hex_digit()
+            {
+                if (at_end())
+                    syntax_error("static_regex: hex digit expected after \\x");
+                const auto cc = static_cast<uint8_t>(peek());
+                ++pos_;
+                if (is_digit(cc))
+                    return static_cast<uint8_t>(cc - '0');
+                if (const auto upper = to_upper(cc); upper >= 'A' && upper <= 'F')
+                    return static_cast<uint8_t>(upper - 'A' + 10);
+                syntax_error("static_regex: hex digit expected after \\x");
+                return 0;
+            }
+
+            // escaped character cc (after \), identity escape for punctuation only:
+            // letters and digits with another meaning in ECMAScript are rejected
+            constexpr uint8_t character_escape(uint8_t cc)
+            {
+                switch (cc) {
+                    case 'n':
+                        return '\n';
+                    case 't':
+                        return '\t';
+                    case 'r':
+                        return '\r';
+                    case 'f':
+                        return '\f';
+                    case 'v':
+                        return '\v';
+                    case '0':
+                        if (!at_end() && is_digit(static_cast<uint8_t>(peek())))
+                            syntax_error("static_regex: octal escapes and backreferences are not supported");
+                        return '\0';
+                    case 'x': {
+                        const auto high = hex_digit();
+                        return static_cast<uint8_t>(high * 16 + hex_digit());
+                    }
+                    default:
+                        if (is_letter(cc) || is_digit(cc))
+                            syntax_error("static_regex: unsupported escape (backreference, \\u, \\p, \\k, \\c ...)");
+                        return cc; // identity escape
+                }
+            }
+
+            constexpr uint16_t escape()
+            {
+                if (at_end())
+                    syntax_error("static_regex: trailing \\");
+                const auto cc = static_cast<uint8_t>(peek());
+                ++pos_;
+                if (char_class_t cls; class_escape(cc, cls))
+                    return add(cls);
+                switch (cc) {
+                    case 'b':
+                        return add(node_t{.kind = node_kind_t::word_boundary});
+                    case 'B':
+                        return add(node_t{.kind = node_kind_t::not_word_boundary});
+                    default:
+                        return character(character_escape(cc));
+                }
+            }
+
+            // after [
+            constexpr char_class_t bracket()
+            {
+                char_class_t cls;
+                bool negate{false};
+                if (!at_end() && peek() == '^') {
+                    negate = true;
+                    ++pos_;
+                }
+                // range start, if previous atom was a single character
+                int previous{-1};
+                while (!at_end() && peek() != ']') {
+                    auto cc = static_cast<uint8_t>(peek());
+                    ++pos_;
+                    if (cc == '-' && previous >= 0 && !at_end() && peek() != ']') {
+                        auto last = static_cast<uint8_t>(peek());
+                        ++pos_;
+                        if (last == '\\') {
+                            if (at_end())
+                                syntax_error("static_regex: trailing \\");
+                            const auto escaped = static_cast<uint8_t>(peek());
+                            ++pos_;
+                            if (escaped == 'b')
+                                last = '\b';
+                            else if (char_class_t cls_end; class_escape(escaped, cls_end))
+                                syntax_error("static_regex: class escape cannot end a range in []");
+                            else
+                                last = character_escape(escaped);
+                        }
+                        if (last < previous)
+                            syntax_error("static_regex: invalid range in []");
+                        cls.set(static_cast<uint8_t>(previous), last);
+                        previous = -1; // "a-z-" : - is literal after range
+                        continue;
+                    }
+                    if (cc == '\\') {
+                        if (at_end())
+                            syntax_error("static_regex: trailing \\");
+                        cc = static_cast<uint8_t>(peek());
+                        ++pos_;
+                        if (class_escape(cc, cls)) {
+                            previous = -1;
+                            continue;
+                        }
+                        cc = cc == 'b' ? uint8_t{'\b'} : character_escape(cc);
+                    }
+                    cls.set(cc);
+                    previous = cc;
+                }
+                if (at_end())
+                    syntax_error("static_regex: ] expected");
+                ++pos_;
+                if (negate) {
+                    if (parsed_.icase)
+                        cls.fold_case(); // [^a] with icase excludes A too
+                    cls.negate();
+                }
+                return cls;
+            }
+        };
+
+        // ----------------------------------------------------------------------
+
+        // capped at max_code_size + 1, nested repetitions of a run time pattern may need more than size_t
+        template <size_t N> constexpr size_t code_size(const parsed_t<N>& parsed, uint16_t node_no)
+        {
+            const auto capped = [](size_t size) { return std::min(size, max_code_size + 1); };
+            const auto& node = parsed.nodes[node_no];
+            switch (node.kind) {
+                case node_kind_t::empty:
+                    return 0;
+                case node_kind_t::character:
+                case node_kind_t::any:
+                case node_kind_t::char_class:
+                case node_kind_t::bol:
+                case node_kind_t::eol:
+                case node_kind_t::word_boundary:
+                case node_kind_t::not_word_boundary:
+                    return 1;
+                case node_kind_t::group:
+                    return capped(code_size(parsed, node.left) + 2);
+                case node_kind_t::concat:
+                    return capped(code_size(parsed, node.left) + code_size(parsed, node.right));
+                case node_kind_t::alternate:
+                    return capped(code_size(parsed, node.left) + code_size(parsed, node.right) + 2);
+                case node_kind_t::repeat: {
+                    const auto child = code_size(parsed, node.left);
+                    if (node.max == unbounded)
+                        return capped(node.min * child + child + 2);
+                    else
+                        return capped(node.min * child + static_cast<size_t>(node.max - node.min) * (child + 1));
+                }
+            }
+            return 0;
+        }
+
+        // save 0, pattern, save 1, match
+        template <size_t N> constexpr size_t code_size(const parsed_t<N>& parsed) { return std::min(code_size(parsed, parsed.root) + 3, max_code_size + 1); }
+
+        // Code: std::array for patterns compiled at compile time, std::vector for run time
+        template <typename Code, size_t N> class generator_t
+        {
+          public:
+            constexpr generator_t(const parsed_t<N>& parsed, Code&& code) : parsed_{parsed}, code_{std::move(code)} {}
+
+            constexpr Code generate()
+            {
+                if (code_size(parsed_) > max_code_size)
+                    syntax_error("static_regex: program too big (repetition count or too many alternatives)");
+                emit(inst_t{.op = op_t::save, .arg1 = 0});
+                generate(parsed_.root);
+                emit(inst_t{.op = op_t::save, .arg1 = 1});
+                emit(inst_t{.op = op_t::match});
+                return code_;
+            }
+
+          private:
+            const parsed_t<N>& parsed_;
+            Code code_;
+            size_t pc_{0};
+
+            constexpr size_t emit(const inst_t& inst)
+            {
+                code_[pc_] = inst;
+                return pc_++;
+            }
+
+            constexpr uint16_t here() const { return static_cast<uint16_t>(pc_); }
+
+            constexpr void split(size_t at, uint16_t next, uint16_t skip, bool greedy)
+            {
+                code_[at] = greedy ? inst_t{.op = op_t::split, .arg1 = next, .arg2 = skip} : inst_t{.op = op_t::split, .arg1 = skip, .arg2 = next};
+            }
+
+            constexpr void generate(uint16_t node_no)
+            {
+                const auto& node = parsed_.nodes[node_no];
+                switch (node.kind) {
+                    case node_kind_t::empty:
+                        break;
+                    case node_kind_t::character:
+                        emit(inst_t{.op = op_t::character, .ch = node.ch});
+                        break;
+                    case node_kind_t::any:
+                        emit(inst_t{.op = op_t::any});
+                        break;
+                    case node_kind_t::char_class:
+                        emit(inst_t{.op = op_t::char_class, .arg1 = node.arg});
+                        break;
+                    case node_kind_t::bol:
+                        emit(inst_t{.op = op_t::bol});
+                        break;
+                    case node_kind_t::eol:
+                        emit(inst_t{.op = op_t::eol});
+                        break;
+                    case node_kind_t::word_boundary:
+                        emit(inst_t{.op = op_t::word_boundary});
+                        break;
+                    case node_kind_t::not_word_boundary:
+                        emit(inst_t{.op = op_t::not_word_boundary});
+                        break;
+                    case node_kind_t::group:
+                        emit(inst_t{.op = op_t::save, .arg1 = static_cast<uint16_t>(node.arg * 2)});
+                        generate(node.left);
+                        emit(inst_t{.op = op_t::save, .arg1 = static_cast<uint16_t>(node.arg * 2 + 1)});
+                        break;
+                    case node_kind_t::concat:
+                        generate(node.left);
+                        generate(node.right);
+                        break;
+                    case node_kind_t::alternate: {
+                        const auto at_split = emit(inst_t{});
+                        const auto left = here();
+                        generate(node.left);
+                        const auto at_jump = emit(inst_t{});
+                        split(at_split, left, here(), true);
+                        generate(node.right);
+                        code_[at_jump] = inst_t{.op = op_t::jump, .arg1 = here()};
+                    } break;
+                    case node_kind_t::repeat:
+                        for (size_t no = 0; no < node.min; ++no)
+                            generate(node.left);
+                        if (node.max == unbounded) {
+                            const auto at_split = emit(inst_t{});
+                            generate(node.left);
+                            emit(inst_t{.op = op_t::jump, .arg1 = static_cast<uint16_t>(at_split)});
+                            split(at_split, static_cast<uint16_t>(at_split + 1), here(), node.greedy);
+                        }
+                        else if (node.max > node.min) {
+                            // x{0,3} is (?:x(?:x(?:x)?)?)?, each split skips to the end of all
+                            const auto first = pc_;
+                            const auto child_size = code_size(parsed_, node.left);
+                            for (size_t no = node.min; no < node.max; ++no) {
+                                emit(inst_t{});
+                                generate(node.left);
+                            }
+                            for (size_t no = 0; no < static_cast<size_t>(node.max - node.min); ++no) {
+                                const auto at_split = first + no * (child_size + 1);
+                                split(at_split, static_cast<uint16_t>(at_split + 1), here(), node.greedy);
+                            }
+                        }
+                        break;
+                }
+            }
+        };
+
+        template <size_t Size, size_t N> constexpr std::array<char_class_t, Size> classes(const parsed_t<N>& parsed)
+        {
+            std::array<char_class_t, Size> result{};
+            std::copy_n(parsed.classes.begin(), Size, result.begin());
+            return result;
+        }
+
+        // ----------------------------------------------------------------------
+
+        // literal strings derived bottom up: exact - the only string the node matches,
+        // prefix/suffix - every match starts/ends with, required - every match contains
+        struct literal_t
+        {
+            std::array<char, prefilter_t::max_literal> data{};
+            size_t size{0};
+
+            constexpr std::string_view view() const { return {data.data(), size}; }
+
+            // truncated, if too long, keep_end keeps the last characters
+            static constexpr literal_t make(std::string_view first, std::string_view second, bool keep_end = false)
+            {
+                literal_t result;
+                const auto total = first.size() + second.size();
+                const auto skip = (keep_end && total > result.data.size()) ? total - result.data.size() : size_t{0};
+                for (size_t pos = skip; pos < total && result.size < result.data.size(); ++pos)
+                    result.data[result.size++] = pos < first.size() ? first[pos] : second[pos - first.size()];
+                return result;
+            }
+
+            static constexpr literal_t longest(const literal_t& l1, const literal_t& l2) { return l2.size > l1.size ? l2 : l1; }
+        };
+
+        struct literal_info_t
+        {
+            bool exact{false};
+            bool exact_fits{true}; // exact string was not truncated
+            literal_t prefix{};    // the exact string, if exact
+            literal_t suffix{};
+            literal_t required{};
+            size_t min_length{0};
+        };
+
+        constexpr literal_info_t exact_literal(std::string_view text)
+        {
+            const auto lit = literal_t::make(text, {});
+            return literal_info_t{.exact = true, .prefix = lit, .suffix = lit, .required = lit, .min_length = text.size()};
+        }
+
+        // single character of a class, e.g. [A] or [Aa] with icase (folded), 0 if class has several
+        constexpr uint8_t single_char(const char_class_t& cls, bool icase)
+        {
+            size_t count{0};
+            uint8_t found{0};
+            for (unsigned cc = 0; cc < 256; ++cc) {
+                if (cls.test(static_cast<uint8_t>(cc)) && (!icase || fold(static_cast<uint8_t>(cc)) == cc)) {
+                    ++count;
+                    found = static_cast<uint8_t>(cc);
+                }
+            }
+            return count == 1 && found != 0 ? found : uint8_t{0};
+        }
+
+        template <size_t N> constexpr literal_info_t literal_info(const parsed_t<N>& parsed, uint16_t node_no)
+        {
+            const auto& node = parsed.nodes[node_no];
+            switch (node.kind) {
+                case node_kind_t::empty:
+                case node_kind_t::bol:
+                case node_kind_t::eol:
+                case node_kind_t::word_boundary:
+                case node_kind_t::not_word_boundary:
+                    return exact_literal({}); // zero width
+                case node_kind_t::character: {
+                    const char cc[1]{static_cast<char>(node.ch)};
+                    return exact_literal({cc, 1});
+                }
+                case node_kind_t::char_class:
+                    if (const auto cc = single_char(parsed.classes[node.arg], parsed.icase); cc != 0) {
+                        const char text[1]{static_cast<char>(cc)};
+                        return exact_literal({text, 1});
+                    }
+                    return literal_info_t{.min_length = 1};
+                case node_kind_t::any:
+                    return literal_info_t{.min_length = 1};
+                case node_kind_t::group:
+                    return literal_info(parsed, node.left);
+                case node_kind_t::concat: {
+                    const auto left = literal_info(parsed, node.left), right = literal_info(parsed, node.right);
+                    literal_info_t result{.min_length = left.min_length + right.min_length};
+                    result.exact = left.exact && right.exact && left.exact_fits && right.exact_fits;
+                    result.exact_fits = (left.prefix.size + right.prefix.size) <= prefilter_t::max_literal;
+                    result.prefix = left.exact && left.exact_fits ? literal_t::make(left.prefix.view(), right.prefix.view()) : left.prefix;
+                    result.suffix = right.exact && right.exact_fits ? literal_t::make(left.suffix.view(), right.suffix.view(), true) : right.suffix;
+                    result.required = literal_t::longest(literal_t::longest(left.required, right.required), literal_t::make(left.suffix.view(), right.prefix.view()));
+                    result.required = literal_t::longest(result.required, result.prefix);
+                    result.required = literal_t::longest(result.required, result.suffix);
+                    return result;
+                }
+                case node_kind_t::alternate: {
+                    const auto left = literal_info(parsed, node.left), right = literal_info(parsed, node.right);
+                    literal_info_t result{.min_length = std::min(left.min_length, right.min_length)};
+                    size_t common_prefix{0}, common_suffix{0};
+                    while (common_prefix < std::min(left.prefix.size, right.prefix.size) && left.prefix.data[common_prefix] == right.prefix.data[common_prefix])
+                        ++common_prefix;
+                    while (common_suffix < std::min(left.suffix.size, right.suffix.size) &&
+                           left.suffix.data[left.suffix.size - common_suffix - 1] == right.suffix.data[right.suffix.size - common_suffix - 1])
+                        ++common_suffix;
+                    result.prefix = literal_t::make(left.prefix.view().substr(0, common_prefix), {});
+                    result.suffix = literal_t::make(left.suffix.view().substr(left.suffix.size - common_suffix), {});
+                    result.exact = left.exact && right.exact && left.exact_fits && right.exact_fits && left.prefix.view() == right.prefix.view();
+                    result.required = left.required.view() == right.required.view() ? left.required : literal_t::longest(result.prefix, result.suffix);
+                    return result;
+                }
+                case node_kind_t::repeat: {
+                    if (node.min == 0)
+                        return literal_info_t{};
+                    const auto child = literal_info(parsed, node.left);
+                    literal_info_t result{.prefix = child.prefix, .suffix = child.suffix, .required = child.required, .min_length = child.min_length * node.min};
+                    if (child.exact && child.exact_fits && node.min == node.max) {
+                        for (size_t no = 1; no < node.min; ++no) {
+                            result.prefix = literal_t::make(result.prefix.view(), child.prefix.view());
+                            result.suffix = literal_t::make(result.suffix.view(), child.suffix.view(), true);
+                        }
+                        result.exact = true;
+                        result.exact_fits = child.prefix.size * node.min <= prefilter_t::max_literal;
+                        result.required = literal_t::longest(result.required, result.prefix);
+                    }
+                    return result;
+                }
+            }
+            return {};
+        }
+
+        template <size_t N> constexpr prefilter_t make_prefilter(const parsed_t<N>& parsed)
+        {
+            const auto info = literal_info(parsed, parsed.root);
+            prefilter_t result{.literal_size = info.required.size, .min_length = info.min_length, .icase = parsed.icase};
+            std::copy_n(info.required.data.begin(), info.required.size, result.literal.begin());
+            return result;
+        }
+
+    } // namespace detail
+
+    // ----------------------------------------------------------------------
+
+    // non-owning reference to a compiled program, static_regex converts to it
+    struct program_ref_t
+    {
+        std::span<const detail::inst_t> code;
+        std::span<const detail::char_class_t> classes;
+        size_t number_of_groups{0}; // capturing groups, whole match is not counted
+        bool icase{false};
+        prefilter_t prefilter{};
+    };
+
+    template <fixed_string Pattern, bool Icase = true> class static_regex
+    {
+      private:
+        static constexpr const auto parsed_ = detail::parser_t<decltype(Pattern)::capacity>{Pattern.view(), Icase}.parse();
+        static constexpr const auto code_ = detail::generator_t<std::array<detail::inst_t, detail::code_size(parsed_)>, decltype(Pattern)::capacity>{parsed_, {}}.generate();
+        static constexpr const auto classes_ = detail::classes<parsed_.number_of_classes>(parsed_);
+        static constexpr const auto prefilter_ = detail::make_prefilter(parsed_);
+
+      public:
+        static constexpr const size_t number_of_groups{parsed_.number_of_groups};
+        static constexpr const size_t code_size{code_.size()};
+        static constexpr const size_t number_of_classes{classes_.size()};
+
+        constexpr std::string_view pattern() const { return Pattern.view(); }
+        constexpr const prefilter_t& prefilter() const { return prefilter_; }
+        constexpr program_ref_t program() const { return program_ref_t{.code = code_, .classes = classes_, .number_of_groups = number_of_groups, .icase = Icase, .prefilter = prefilter_}; }
+        constexpr operator program_ref_t() const { return program(); }
+    };
+
+    // ----------------------------------------------------------------------
+
+    // Pattern supplied at run time (e.g. from python) compiled for the same engine
+    class dynamic_regex
+    {
+      public:
+        static constexpr const size_t max_pattern_size{512};
+
+        dynamic_regex(std::string_view pattern, bool icase = true); // throws std::invalid_argument on syntax error
+
+        std::string_view pattern() const { return pattern_; }
+        program_ref_t program() const { return program_ref_t{.code = code_, .classes = classes_, .number_of_groups = number_of_groups_, .icase = icase_, .prefilter = prefilter_}; }
+        operator program_ref_t() const { return program(); }
+
+      private:
+        std::string pattern_;
+        std::vector<detail::inst_t> code_;
+        std::vector<detail::char_class_t> classes_;
+        size_t number_of_groups_;
+        bool icase_;
+        prefilter_t prefilter_;
+    };
+
+    // ----------------------------------------------------------------------
+
+    using set_mask_t = uint64_t; // bit per pattern of a set
+
+    // non-owning reference to a compiled set, ae::regex::set converts to it
+    struct set_ref_t
+    {
+        program_ref_t program;                 // union of the patterns, match instruction tells pattern number
+        std::span<const program_ref_t> patterns; // to extract groups of a particular pattern
+        size_t size() const { return patterns.size(); }
+    };
+
+    namespace detail
+    {
+        // pattern programs one after another preceded by the splits to every pattern start,
+        // jumps and classes are relocated, match instruction gets pattern number
+        template <size_t Size, size_t N> constexpr std::array<inst_t, Size> merge_code(const std::array<program_ref_t, N>& patterns)
+        {
+            std::array<inst_t, Size> code{};
+            std::array<uint16_t, N> starts{};
+            starts[0] = static_cast<uint16_t>(N - 1);
+            for (size_t pattern_no = 1; pattern_no < N; ++pattern_no)
+                starts[pattern_no] = static_cast<uint16_t>(starts[pattern_no - 1] + patterns[pattern_no - 1].code.size());
+            for (size_t pattern_no = 0; (pattern_no + 1) < N; ++pattern_no)
+                code[pattern_no] = inst_t{.op = op_t::split, .arg1 = starts[pattern_no], .arg2 = static_cast<uint16_t>((pattern_no + 2) < N ? pattern_no + 1 : starts[N - 1])};
+
+            uint16_t class_offset{0};
+            for (size_t pattern_no = 0; pattern_no < N; ++pattern_no) {
+                for (size_t pc = 0; pc < patterns[pattern_no].code.size(); ++pc) {
+                    auto inst = patterns[pattern_no].code[pc];
+                    switch (inst.op) {
+                        case op_t::split:
+                            inst.arg2 = static_cast<uint16_t>(inst.arg2 + starts[pattern_no]);
+                            [[fallthrough]];
+                        case op_t::jump:
+                            inst.arg1 = static_cast<uint16_t>(inst.arg1 + starts[pattern_no]);
+                            break;
+                        case op_t::char_class:
+                            inst.arg1 = static_cast<uint16_t>(inst.arg1 + class_offset);
+                            break;
+                        case op_t::match:
+                            inst.arg1 = static_cast<uint16_t>(pattern_no);
+                            break;
+                        case op_t::character:
+                        case op_t::any:
+                        case op_t::bol:
+                        case op_t::eol:
+                        case op_t::word_boundary:
+                        case op_t::not_word_boundary:
+                        case op_t::save:
+                            break;
+                    }
+                    code[starts[pattern_no] + pc] = inst;
+                }
+                class_offset = static_cast<uint16_t>(class_offset + patterns[pattern_no].classes.size());
+            }
+            return code;
+        }
+
+        template <size_t Size, size_t N> constexpr std::array<char_class_t, Size> merge_classes(const std::array<program_ref_t, N>& patterns)
+        {
+            std::array<char_class_t, Size> classes{};
+            size_t class_no{0};
+            for (const auto& pattern : patterns) {
+                for (const auto& cls : pattern.classes)
+                    classes[class_no++] = cls;
+            }
+            return classes;
+        }
+
+    } // namespace detail
+
+    // Patterns compiled together, search() on a set returns all matching
+    // patterns in one scan of the text
+    //
+    //   static constexpr ae::regex::set<"^LOT$", "^SPECIES$"> re_labels;
+    //   const auto mask = ae::regex::search(text, re_labels); // bit 0: LOT matched, bit 1: SPECIES matched
+    template <fixed_string... Patterns> class set
+    {
+      private:
+        static constexpr const size_t size_{sizeof...(Patterns)};
+        static_assert(size_ > 0 && size_ <= sizeof(set_mask_t) * 8, "ae::regex::set: invalid number of patterns");
+
+        static constexpr const std::array<program_ref_t, size_> patterns_{static_regex<Patterns>{}.program()...};
+        static constexpr const std::array<std::string_view, size_> pattern_texts_{Patterns.view()...};
+        static constexpr const auto code_ = detail::merge_code<(size_ - 1) + (static_regex<Patterns>::code_size + ...)>(patterns_);
+        static_assert(code_.size() <= detail::max_code_size, "ae::regex::set: program too big");
+        static constexpr const auto classes_ = detail::merge_classes<(static_regex<Patterns>::number_of_classes + ...)>(patterns_);
+        // no literal is common to all patterns in general, only the length is prefiltered
+        static constexpr const prefilter_t prefilter_{.min_length = std::min({static_regex<Patterns>{}.prefilter().min_length...}), .icase = true};
+
+      public:
+        static constexpr const size_t number_of_groups{std::max({static_regex<Patterns>::number_of_groups...})};
+
+        static constexpr size_t size() { return size_; }
+        constexpr program_ref_t operator[](size_t pattern_no) const { return patterns_[pattern_no]; }
+        constexpr std::string_view pattern(size_t pattern_no) const { return pattern_texts_[pattern_no]; }
+
+        constexpr set_ref_t ref() const
+        {
+            return set_ref_t{.program = program_ref_t{.code = code_, .classes = classes_, .number_of_groups = number_of_groups, .icase = true, .prefilter = prefilter_}, .patterns = patterns_};
+        }
+        constexpr operator set_ref_t() const { return ref(); }
+    };
+
+    // ----------------------------------------------------------------------
+
+    namespace detail
+    {
+        // groups of a match including the whole match, any number of them,
+        // the first inline_size are stored without allocation
+        class groups_t
+        {
+          public:
+            static constexpr const size_t inline_size{10};
+
+            size_t size() const { return size_; }
+            void resize(size_t size)
+            {
+                size_ = size;
+                if (size_ > inline_size)
+                    more_.resize(size_ - inline_size);
+            }
+
+            std::string_view& operator[](size_t group_no) { return group_no < inline_size ? inline_[group_no] : more_[group_no - inline_size]; }
+            std::string_view operator[](size_t group_no) const { return group_no < inline_size ? inline_[group_no] : more_[group_no - inline_size]; }
+
+          private:
+            std::array<std::string_view, inline_size> inline_{};
+            std::vector<std::string_view> more_{};
+            size_t size_{0};
+        };
+
+    } // namespace detail
+
+    // groups of the last match, views into the searched string
+    class match_t
+    {
+      public:
+        size_t size() const { return groups_.size(); }
+        bool empty() const { return groups_.size() == 0; }
+        std::string_view operator[](size_t group_no) const { return group_no < groups_.size() ? groups_[group_no] : std::string_view{}; }
+        std::string str(size_t group_no) const { return std::string{(*this)[group_no]}; }
+        size_t position(size_t group_no) const { return static_cast<size_t>((*this)[group_no].data() - input_.data()); } // group must be matched
+        std::string_view prefix() const { return input_.substr(0, position(0)); }
+        std::string_view suffix() const { return input_.substr(position(0) + groups_[0].size()); }
+
+        // $n, $nn, $&, $`, $', $$ are substituted like std::match_results::format does
+        std::string format(std::string_view fmt) const;
+
+      private:
+        std::string_view input_{};
+        detail::groups_t groups_{};
+
+        friend bool execute(const program_ref_t& program, std::string_view input, size_t start, bool full, match_t* match);
+        friend bool execute_folded(const program_ref_t& program, std::string_view folded, std::string_view input, bool full, match_t* match);
+        friend class regex_t; // utils/regex-backend.hh
+    };
+
+    // start: where matching starts, ^ and \b still look at the whole input
+    // full: match must end at the end of input (and start at start)
+    // match: may be nullptr, then captures are not tracked
+    bool execute(const program_ref_t& program, std::string_view input, size_t start, bool full, match_t* match);
+
+    inline bool search(std::string_view search_in, const program_ref_t& program) { return execute(program, search_in, 0, false, nullptr); }
+    inline bool search(std::string_view search_in, match_t& match, const program_ref_t& program) { return execute(program, search_in, 0, false, &match); }
+    inline bool match(std::string_view input, const program_ref_t& program) { return execute(program, input, 0, true, nullptr); }
+    inline bool match(std::string_view input, match_t& match, const program_ref_t& program) { return execute(program, input, 0, true, &match); }
+
+    // target receives source.size() folded characters (ASCII uppercase),
+    // offsets in the folded text are offsets in source
+    void fold(std::string_view source, char* target);
+
+    // folded: input passed through fold(), icase program runs on it without
+    // folding each character, groups of match refer to input.
+    // Case sensitive program or folded of a different size: input is searched.
+    bool execute_folded(const program_ref_t& program, std::string_view folded, std::string_view input, bool full, match_t* match);
+
+    inline bool search_folded(std::string_view folded, std::string_view search_in, const program_ref_t& program) { return execute_folded(program, folded, search_in, false, nullptr); }
+    inline bool search_folded(std::string_view folded, std::string_view search_in, match_t& match, const program_ref_t& program) { return execute_folded(program, folded, search_in, false, &match); }
+
+    // bits of all patterns of the set matching search_in
+    set_mask_t execute(const set_ref_t& set, std::string_view search_in);
+
+    inline set_mask_t search(std::string_view search_in, const set_ref_t& set) { return execute(set, search_in); }
+
+    // folded as for execute_folded above
+    set_mask_t execute_folded(const set_ref_t& set, std::string_view folded, std::string_view search_in);
+
+    inline set_mask_t search_folded(std::string_view folded, std::string_view search_in, const set_ref_t& set) { return execute_folded(set, folded, search_in); }
+
+    // lowest matching pattern number of the set and its groups, nullopt if none matches
+    inline std::optional<size_t> search(std::string_view search_in, match_t& match, const set_ref_t& set)
+    {
+        if (const auto mask = execute(set, search_in); mask != 0) {
+            const auto pattern_no = static_cast<size_t>(std::countr_zero(mask));
+            search(search_in, match, set.patterns[pattern_no]);
+            return pattern_no;
+        }
+        return std::nullopt;
+    }
+
+    // replaces all matches, fmt as in match_t::format
+    std::string replace(std::string_view source, const program_ref_t& program, std::string_view fmt);
+
+} // namespace ae::regex
+
+// ======================================================================
@@ -0,0 +1,82 @@
+#include <cstdlib>
+#include <string>
+
+#include "utils/log.hh"
+#include "utils/thread-pool.hh"
+
+// ----------------------------------------------------------------------
+
+ae::parallel::thread_pool_t::thread_pool_t(size_t number_of_workers)
+{
+    workers_.reserve(number_of_workers);
+    for (size_t worker_no = 0; worker_no < number_of_workers; ++worker_no)
+        workers_.emplace_back([this] { work(); });
+
+} // ae::parallel::thread_pool_t::thread_pool_t
+
+// ----------------------------------------------------------------------
+
+ae::parallel::thread_pool_t::~thread_pool_t()
+{
+    {
+        std::unique_lock lock{mutex_};
+        stop_ = true;
+    }
+    task_available_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+
+} // ae::parallel::thread_pool_t::~thread_pool_t
+
+// ----------------------------------------------------------------------
+
+void ae::parallel::thread_pool_t::submit(std::function<void()> task)
+{
+    {
+        std::unique_lock lock{mutex_};
+        tasks_.push_back(std::move(task));
+    }
+    task_available_.notify_one();
+
+} // ae::parallel::thread_pool_t::submit
+
+// ----------------------------------------------------------------------
+
+void ae::parallel::thread_pool_t::work()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock{mutex_};
+            task_available_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty())
+                return; // stopped
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+
+} // ae::parallel::thread_pool_t::work
+
+// ----------------------------------------------------------------------
+
+ae::parallel::thread_pool_t& ae::parallel::shared_pool()
+{
+    static thread_pool_t pool{[]() -> size_t {
+        size_t threads = std::thread::hardware_concurrency();
+        if (const char* env = std::getenv("AE_THREADS"); env != nullptr && *env != '\0') {
+            try {
+                threads = std::stoul(env);
+            }
+            catch (std::exception&) {
+                AD_WARNING("invalid AE_THREADS=\"{}\" ignored", env);
+            }
+        }
+        return threads > 1 ? threads - 1 : 0; // calling thread works too
+    }()};
+    return pool;
+
+} // ae::parallel::shared_pool
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ======================================================================
+// Threads shared by the parallel scans of the process (Sheet::grep etc.)
+//
+//   ae::parallel::for_each_block(number_of_blocks, [&](size_t block_no) { ... });
+//
+// The calling thread processes blocks too and returns when all of them
+// are done, the first exception thrown by func is rethrown there. Blocks
+// left unclaimed by busy workers are processed by the caller, nested
+// for_each_block calls do not deadlock.
+//
+// Number of workers: AE_THREADS environment variable minus the calling
+// thread, hardware concurrency by default. AE_THREADS=1 makes scans serial.
+// ======================================================================
+
+namespace ae::parallel
+{
+    class thread_pool_t
+    {
+      public:
+        explicit thread_pool_t(size_t number_of_workers);
+        ~thread_pool_t();
+        thread_pool_t(const thread_pool_t&) = delete;
+        thread_pool_t& operator=(const thread_pool_t&) = delete;
+
+        size_t size() const { return workers_.size(); }
+        void submit(std::function<void()> task);
+
+      private:
+        std::vector<std::thread> workers_{};
+        std::deque<std::function<void()>> tasks_{};
+        std::mutex mutex_{};
+        std::condition_variable task_available_{};
+        bool stop_{false};
+
+        void work();
+    };
+
+    thread_pool_t& shared_pool(); // created on first use
+
+    namespace detail
+    {
+        // blocks of one for_each_block call, claimed by the caller and the workers
+        struct blocks_t
+        {
+            explicit blocks_t(size_t a_number_of_blocks) : number_of_blocks{a_number_of_blocks} {}
+
+            template <typename Func> void process(Func& func)
+            {
+                for (auto block_no = next.fetch_add(1); block_no < number_of_blocks; block_no = next.fetch_add(1)) {
+                    try {
+                        func(block_no);
+                    }
+                    catch (...) {
+                        std::unique_lock lock{mutex};
+                        if (!error)
+                            error = std::current_exception();
+                    }
+                    std::unique_lock lock{mutex};
+                    if (++done == number_of_blocks)
+                        all_done.notify_all();
+                }
+            }
+
+            const size_t number_of_blocks;
+            std::atomic<size_t> next{0};
+            size_t done{0}; // guarded by mutex
+            std::exception_ptr error{};
+            std::mutex mutex{};
+            std::condition_variable all_done{};
+        };
+
+    } // namespace detail
+
+    template <typename Func> void for_each_block(size_t number_of_blocks, Func&& func)
+    {
+        auto& pool = shared_pool();
+        if (number_of_blocks < 2 || pool.size() == 0) {
+            for (size_t block_no = 0; block_no < number_of_blocks; ++block_no)
+                func(block_no);
+            return;
+        }
+
+        // worker starting after all blocks are claimed finds nothing to do, func is not touched then
+        auto blocks = std::make_shared<detail::blocks_t>(number_of_blocks);
+        for (size_t helper = 0; helper < std::min(pool.size(), number_of_blocks - 1); ++helper)
+            pool.submit([blocks, &func] { blocks->process(func); });
+        blocks->process(func);
+
+        std::unique_lock lock{blocks->mutex};
+        blocks->all_done.wait(lock, [&blocks] { return blocks->done == blocks->number_of_blocks; });
+        if (blocks->error)
+            std::rethrow_exception(blocks->error);
+    }
+
+} // namespace ae::parallel
+
+// ======================================================================
@@ -0,0 +1,294 @@
+#include <iterator>
+#include <stdexcept>
+
+#include "xlsx/cell-index.hh"
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::v1::cell_kind ae::xlsx::v1::cell_kind_from_string(std::string_view source)
+{
+    if (source == "non-empty")
+        return cell_kind::non_empty;
+    if (source == "string")
+        return cell_kind::string;
+    if (source == "integer")
+        return cell_kind::integer;
+    if (source == "double")
+        return cell_kind::real;
+    if (source == "date")
+        return cell_kind::date;
+    if (source == "titer")
+        return cell_kind::maybe_titer;
+    throw std::invalid_argument{fmt::format("unrecognized cell kind \"{}\" (non-empty, string, integer, double, date, titer expected)", source)};
+
+} // ae::xlsx::v1::cell_kind_from_string
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::v1::cell_type_index_t::cell_type_index_t(const Sheet& sheet)
+    : number_of_rows_{sheet.number_of_rows()}, number_of_columns_{sheet.number_of_columns()}
+{
+    for (auto& rows : rows_)
+        rows.resize(*number_of_rows_, bitset_t{*number_of_columns_});
+    for (auto& columns : columns_)
+        columns.resize(*number_of_columns_, bitset_t{*number_of_rows_});
+
+    const auto set = [this](nrow_t row, ncol_t col, cell_kind kind) {
+        rows_[index(kind)][*row].set(*col);
+        columns_[index(kind)][*col].set(*row);
+    };
+
+    for (nrow_t row{0}; row < number_of_rows_; ++row) {
+        ncol_t col{0};
+        for (const auto cell : sheet.row(row)) {
+            switch (cell.type()) {
+                case cell_type::empty:
+                    break;
+                case cell_type::string:
+                    set(row, col, cell_kind::string);
+                    break;
+                case cell_type::integer:
+                    set(row, col, cell_kind::integer);
+                    break;
+                case cell_type::real:
+                    set(row, col, cell_kind::real);
+                    break;
+                case cell_type::date:
+                    set(row, col, cell_kind::date);
+                    break;
+                case cell_type::error:
+                case cell_type::boolean:
+                    break;
+            }
+            if (!cell.is_empty()) {
+                set(row, col, cell_kind::non_empty);
+                if (sheet.maybe_titer(cell))
+                    set(row, col, cell_kind::maybe_titer);
+            }
+            ++col;
+        }
+    }
+
+    titer_ranges_.reserve(*number_of_rows_);
+    for (nrow_t row{0}; row < number_of_rows_; ++row)
+        titer_ranges_.push_back(longest_run(row, cell_kind::maybe_titer));
+
+} // ae::xlsx::v1::cell_type_index_t::cell_type_index_t
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::v1::column_range ae::xlsx::v1::cell_type_index_t::longest_run(nrow_t row, cell_kind kind) const
+{
+    column_range result;
+    if (const auto [first, length] = this->row(row, kind).longest_run(); length > 0) {
+        result.first = ncol_t{first};
+        result.second = ncol_t{first + length - 1};
+    }
+    return result;
+
+} // ae::xlsx::v1::cell_type_index_t::longest_run
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::v1::row_range ae::xlsx::v1::cell_type_index_t::longest_run(ncol_t col, cell_kind kind) const
+{
+    row_range result;
+    if (const auto [first, length] = column(col, kind).longest_run(); length > 0) {
+        result.first = nrow_t{first};
+        result.second = nrow_t{first + length - 1};
+    }
+    return result;
+
+} // ae::xlsx::v1::cell_type_index_t::longest_run
+
+// ----------------------------------------------------------------------
+
+std::optional<ae::xlsx::v1::nrow_t> ae::xlsx::v1::cell_type_index_t::last_non_empty_row() const
+{
+    for (nrow_t row{number_of_rows_}; row > nrow_t{0}; --row) {
+        if (!this->row(row - nrow_t{1}, cell_kind::non_empty).none())
+            return row - nrow_t{1};
+    }
+    return std::nullopt;
+
+} // ae::xlsx::v1::cell_type_index_t::last_non_empty_row
+
+// ----------------------------------------------------------------------
+
+std::optional<ae::xlsx::v1::ncol_t> ae::xlsx::v1::cell_type_index_t::last_non_empty_column() const
+{
+    for (ncol_t col{number_of_columns_}; col > ncol_t{0}; --col) {
+        if (!column(col - ncol_t{1}, cell_kind::non_empty).none())
+            return col - ncol_t{1};
+    }
+    return std::nullopt;
+
+} // ae::xlsx::v1::cell_type_index_t::last_non_empty_column
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::v1::bitset_t ae::xlsx::v1::cell_type_index_t::rows_mask(const std::vector<nrow_t>& rows) const
+{
+    bitset_t mask{*number_of_rows_};
+    for (const auto row : rows) {
+        if (row < number_of_rows_)
+            mask.set(*row);
+    }
+    return mask;
+
+} // ae::xlsx::v1::cell_type_index_t::rows_mask
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    inline std::string fold_text(std::string_view source)
+    {
+        std::string folded(source.size(), ' ');
+        ae::regex::fold(source, folded.data());
+        return folded;
+    }
+
+    // calls func(token) for each token of folded text
+    template <typename Func> inline void for_each_token(std::string_view folded, Func&& func)
+    {
+        for (size_t pos = 0; pos < folded.size();) {
+            if (cell_token_index_t::is_token_char(folded[pos])) {
+                const auto first = pos;
+                while (pos < folded.size() && cell_token_index_t::is_token_char(folded[pos]))
+                    ++pos;
+                func(folded.substr(first, pos - first));
+            }
+            else
+                ++pos;
+        }
+    }
+
+    inline bool row_major(const cell_addr_t& a1, const cell_addr_t& a2) { return a1.row == a2.row ? a1.col < a2.col : a1.row < a2.row; }
+    inline bool same_cell(const cell_addr_t& a1, const cell_addr_t& a2) { return a1.row == a2.row && a1.col == a2.col; }
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::v1::cell_token_index_t::cell_token_index_t(const Sheet& sheet)
+{
+    for (nrow_t row{0}; row < sheet.number_of_rows(); ++row) {
+        ncol_t col{0};
+        for (const auto cell : sheet.row(row)) {
+            if (!cell.is_empty()) {
+                for_each_token(cell.folded(), [this, row, col](std::string_view token) {
+                    auto& cells = cells_[std::string{token}];
+                    if (cells.empty() || !same_cell(cells.back(), {row, col})) // token repeated in the cell
+                        cells.push_back({row, col});
+                });
+            }
+            ++col;
+        }
+    }
+
+    tokens_.reserve(cells_.size());
+    for (const auto& [token, cells] : cells_)
+        tokens_.push_back(token);
+    std::sort(std::begin(tokens_), std::end(tokens_));
+
+} // ae::xlsx::v1::cell_token_index_t::cell_token_index_t
+
+// ----------------------------------------------------------------------
+
+const std::vector<ae::xlsx::v1::cell_addr_t>& ae::xlsx::v1::cell_token_index_t::cells(std::string_view token) const
+{
+    if (const auto found = cells_.find(fold_text(token)); found != cells_.end())
+        return found->second;
+    return empty_;
+
+} // ae::xlsx::v1::cell_token_index_t::cells
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::v1::cell_addr_t> ae::xlsx::v1::cell_token_index_t::cells_of(std::span<const std::string_view> tokens) const
+{
+    std::vector<cell_addr_t> result;
+    for (const auto token : tokens) {
+        const auto& cells = cells_.find(std::string{token})->second;
+        result.insert(std::end(result), std::begin(cells), std::end(cells));
+    }
+    if (tokens.size() > 1) {
+        std::sort(std::begin(result), std::end(result), row_major);
+        result.erase(std::unique(std::begin(result), std::end(result), same_cell), std::end(result));
+    }
+    return result;
+
+} // ae::xlsx::v1::cell_token_index_t::cells_of
+
+// ----------------------------------------------------------------------
+
+template <typename Pred> std::vector<ae::xlsx::v1::cell_addr_t> ae::xlsx::v1::cell_token_index_t::cells_if(Pred pred) const
+{
+    std::vector<std::string_view> tokens;
+    std::copy_if(std::begin(tokens_), std::end(tokens_), std::back_inserter(tokens), pred);
+    return cells_of(tokens);
+
+} // ae::xlsx::v1::cell_token_index_t::cells_if
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::v1::cell_addr_t> ae::xlsx::v1::cell_token_index_t::cells_with_prefix(std::string_view prefix) const
+{
+    const auto folded = fold_text(prefix);
+    // tokens having the prefix are adjacent in tokens_
+    const auto first = std::lower_bound(std::begin(tokens_), std::end(tokens_), std::string_view{folded});
+    const auto last = std::find_if_not(first, std::end(tokens_), [&folded](std::string_view token) { return token.starts_with(folded); });
+    return cells_of({first, last});
+
+} // ae::xlsx::v1::cell_token_index_t::cells_with_prefix
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::v1::cell_addr_t> ae::xlsx::v1::cell_token_index_t::cells_with_tokens(std::string_view text) const
+{
+    std::vector<cell_addr_t> result;
+    bool first{true};
+    for_each_token(fold_text(text), [this, &result, &first](std::string_view token) {
+        if (first) {
+            result = cells(token);
+            first = false;
+        }
+        else {
+            const auto& cells = this->cells(token);
+            std::vector<cell_addr_t> both;
+            std::set_intersection(std::begin(result), std::end(result), std::begin(cells), std::end(cells), std::back_inserter(both), row_major);
+            result = std::move(both);
+        }
+    });
+    return result;
+
+} // ae::xlsx::v1::cell_token_index_t::cells_with_tokens
+
+// ----------------------------------------------------------------------
+
+std::optional<std::vector<ae::xlsx::v1::cell_addr_t>> ae::xlsx::v1::cell_token_index_t::candidates(const ae::regex::prefilter_t& prefilter) const
+{
+    // longest run of token chars in the literal
+    const auto literal = fold_text(prefilter.required());
+    std::string_view run;
+    for_each_token(literal, [&run](std::string_view token) {
+        if (token.size() > run.size())
+            run = token;
+    });
+    if (run.empty())
+        return std::nullopt;
+
+    // run bounded by non-token chars in the literal is a whole token of the cell
+    const auto bounded_before = run.data() != literal.data(), bounded_after = (run.data() + run.size()) != (literal.data() + literal.size());
+    if (bounded_before && bounded_after)
+        return cells(run);
+    if (bounded_before)
+        return cells_with_prefix(run);
+    if (bounded_after)
+        return cells_if([run](std::string_view token) { return token.ends_with(run); });
+    return cells_if([run](std::string_view token) { return token.find(run) != std::string_view::npos; });
+
+} // ae::xlsx::v1::cell_token_index_t::candidates
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "xlsx/sheet.hh"
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    // packed bits, one per cell of a row or a column
+    class bitset_t
+    {
+      public:
+        static constexpr const size_t npos = std::numeric_limits<size_t>::max();
+
+        bitset_t(size_t size = 0) : size_{size}, words_((size + word_bits - 1) / word_bits, 0) {}
+
+        size_t size() const { return size_; }
+        void set(size_t pos) { words_[pos / word_bits] |= bit(pos); }
+        bool test(size_t pos) const { return pos < size_ && (words_[pos / word_bits] & bit(pos)) != 0; }
+        bool none() const { return std::all_of(std::begin(words_), std::end(words_), [](uint64_t word) { return word == 0; }); }
+
+        size_t count() const
+        {
+            size_t result{0};
+            for (const auto word : words_)
+                result += static_cast<size_t>(std::popcount(word));
+            return result;
+        }
+
+        size_t next_set(size_t from) const { return next(from, 0); }           // npos if not found
+        size_t next_clear(size_t from) const { return next(from, ~uint64_t{0}); } // size() if not found
+        size_t first() const { return next_set(0); }
+
+        size_t last() const // npos if none
+        {
+            for (size_t word_no = words_.size(); word_no > 0; --word_no) {
+                if (const auto word = words_[word_no - 1]; word != 0)
+                    return (word_no - 1) * word_bits + word_bits - 1 - static_cast<size_t>(std::countl_zero(word));
+            }
+            return npos;
+        }
+
+        // first longest run of set bits, {npos, 0} if none
+        std::pair<size_t, size_t> longest_run() const
+        {
+            std::pair<size_t, size_t> longest{npos, 0};
+            for (auto first = next_set(0); first != npos;) {
+                const auto end = next_clear(first);
+                if ((end - first) > longest.second)
+                    longest = {first, end - first};
+                first = end < size_ ? next_set(end) : npos;
+            }
+            return longest;
+        }
+
+        template <typename F> void for_each(F&& func) const
+        {
+            for (size_t word_no = 0; word_no < words_.size(); ++word_no) {
+                for (auto word = words_[word_no]; word != 0; word &= word - 1)
+                    func(word_no * word_bits + static_cast<size_t>(std::countr_zero(word)));
+            }
+        }
+
+        bitset_t& operator&=(const bitset_t& rhs)
+        {
+            for (size_t word_no = 0; word_no < words_.size(); ++word_no)
+                words_[word_no] &= word_no < rhs.words_.size() ? rhs.words_[word_no] : 0;
+            return *this;
+        }
+
+        bitset_t& operator|=(const bitset_t& rhs)
+        {
+            for (size_t word_no = 0; word_no < std::min(words_.size(), rhs.words_.size()); ++word_no)
+                words_[word_no] |= rhs.words_[word_no];
+            return *this;
+        }
+
+      private:
+        static constexpr const size_t word_bits{64};
+
+        size_t size_;
+        std::vector<uint64_t> words_;
+
+        static constexpr uint64_t bit(size_t pos) { return uint64_t{1} << (pos % word_bits); }
+
+        // invert: 0 to look for set bits, ~0 to look for clear bits
+        size_t next(size_t from, uint64_t invert) const
+        {
+            if (from >= size_)
+                return invert ? size_ : npos;
+            auto word_no = from / word_bits;
+            auto word = (words_[word_no] ^ invert) & (~uint64_t{0} << (from % word_bits));
+            while (word == 0) {
+                if (++word_no == words_.size())
+                    return invert ? size_ : npos;
+                word = words_[word_no] ^ invert;
+            }
+            const auto found = word_no * word_bits + static_cast<size_t>(std::countr_zero(word));
+            if (found < size_)
+                return found;
+            return invert ? size_ : npos;
+        }
+    };
+
+    inline bitset_t operator&(bitset_t lhs, const bitset_t& rhs) { return lhs &= rhs; }
+
+    // ----------------------------------------------------------------------
+
+    enum class cell_kind : size_t { non_empty, string, integer, real, date, maybe_titer };
+    constexpr const size_t number_of_cell_kinds{static_cast<size_t>(cell_kind::maybe_titer) + 1};
+
+    cell_kind cell_kind_from_string(std::string_view source); // throws std::invalid_argument
+
+    // Per-row and per-column bitsets for each cell kind, built in one pass over
+    // the sheet, layout questions become word-wide bit operations
+    class cell_type_index_t
+    {
+      public:
+        cell_type_index_t(const Sheet& sheet);
+
+        nrow_t number_of_rows() const { return number_of_rows_; }
+        ncol_t number_of_columns() const { return number_of_columns_; }
+
+        const bitset_t& row(nrow_t row, cell_kind kind) const { return *row < rows_[index(kind)].size() ? rows_[index(kind)][*row] : empty_; }
+        const bitset_t& column(ncol_t col, cell_kind kind) const { return *col < columns_[index(kind)].size() ? columns_[index(kind)][*col] : empty_; }
+
+        bool is(nrow_t row, ncol_t col, cell_kind kind) const { return this->row(row, kind).test(*col); }
+
+        column_range longest_run(nrow_t row, cell_kind kind) const; // first longest run of the kind in the row
+        column_range titer_range(nrow_t row) const { return *row < titer_ranges_.size() ? titer_ranges_[*row] : column_range{}; } // longest_run(row, cell_kind::maybe_titer), computed once
+        row_range longest_run(ncol_t col, cell_kind kind) const;    // first longest run of the kind in the column
+
+        std::optional<nrow_t> last_non_empty_row() const;
+        std::optional<ncol_t> last_non_empty_column() const;
+
+        bitset_t rows_mask(const std::vector<nrow_t>& rows) const; // bitset over rows to intersect with column()
+
+      private:
+        nrow_t number_of_rows_;
+        ncol_t number_of_columns_;
+        std::array<std::vector<bitset_t>, number_of_cell_kinds> rows_;    // [kind][row] -> bit per column
+        std::array<std::vector<bitset_t>, number_of_cell_kinds> columns_; // [kind][col] -> bit per row
+        std::vector<column_range> titer_ranges_;                           // [row], Extractor::find_titers asks for every row, possibly for several extractors
+        bitset_t empty_{};
+
+        static constexpr size_t index(cell_kind kind) { return static_cast<size_t>(kind); }
+    };
+
+    // ----------------------------------------------------------------------
+
+    // Inverted index of the cell texts: token -> cells having it, in
+    // row-major order. Tokens are runs of letters, digits and non-ASCII
+    // bytes of the folded text (see ae::regex::fold), "Lot 12/b" has LOT, 12
+    // and B. Lookup arguments are folded the same way.
+    class cell_token_index_t
+    {
+      public:
+        cell_token_index_t(const Sheet& sheet);
+        cell_token_index_t(const cell_token_index_t&) = delete; // tokens_ refer to keys of cells_
+
+        size_t number_of_tokens() const { return cells_.size(); }
+
+        const std::vector<cell_addr_t>& cells(std::string_view token) const;       // empty if not found
+        std::vector<cell_addr_t> cells_with_prefix(std::string_view prefix) const; // cells having a token starting with prefix
+        std::vector<cell_addr_t> cells_with_tokens(std::string_view text) const;   // cells having all tokens of text, e.g. "Sample Date", "NIID-ID"
+
+        // cells possibly matching a pattern (superset): having a token with the letters and digits of the
+        // literal every match contains, nullopt if the pattern has no such literal
+        std::optional<std::vector<cell_addr_t>> candidates(const ae::regex::prefilter_t& prefilter) const;
+
+        static constexpr bool is_token_char(char cc) { return (cc >= '0' && cc <= '9') || (cc >= 'A' && cc <= 'Z') || static_cast<uint8_t>(cc) >= 0x80; } // folded text
+
+      private:
+        std::unordered_map<std::string, std::vector<cell_addr_t>> cells_;
+        std::vector<std::string_view> tokens_; // keys of cells_ sorted, for prefix lookups
+        const std::vector<cell_addr_t> empty_{};
+
+        std::vector<cell_addr_t> cells_of(std::span<const std::string_view> tokens) const; // union in row-major order
+        template <typename Pred> std::vector<cell_addr_t> cells_if(Pred pred) const;       // union for the tokens satisfying pred
+    };
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <variant>
+#include <string>
+#include <limits>
+
+#include "ext/fmt.hh"
+#include "ext/date.hh"
+#include "utils/named-type.hh"
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+
+    namespace cell
+    {
+        class empty
+        {
+        };
+        class error
+        {
+        };
+    } // namespace cell
+
+    using cell_t = std::variant<cell::empty, cell::error, bool, std::string, double, long, std::chrono::year_month_day>;
+
+    inline bool is_empty(const cell_t& cell)
+    {
+        return std::visit(
+            []<typename Content>(const Content&) {
+                if constexpr (std::is_same_v<Content, cell::empty>)
+                    return true;
+                else
+                    return false;
+            },
+            cell);
+    }
+
+    inline bool is_date(const cell_t& cell)
+    {
+        return std::visit(
+            []<typename Content>(const Content&) {
+                if constexpr (std::is_same_v<Content, std::chrono::year_month_day>)
+                    return true;
+                else
+                    return false;
+            },
+            cell);
+    }
+
+    inline bool is_string(const cell_t& cell)
+    {
+        return std::visit(
+            []<typename Content>(const Content&) {
+                if constexpr (std::is_same_v<Content, std::string>)
+                    return true;
+                else
+                    return false;
+            },
+            cell);
+    }
+
+    // ----------------------------------------------------------------------
+
+    constexpr const auto max_row_col = std::numeric_limits<size_t>::max();
+
+    using nrow_t = named_size_t<struct nrow_t_tag>;
+    using ncol_t = named_size_t<struct ncol_t_tag>;
+
+    template <typename nrowcol> concept NRowCol = std::is_same_v<nrowcol, nrow_t> || std::is_same_v<nrowcol, ncol_t>;
+
+    template <NRowCol nrowcol> constexpr bool valid(nrowcol row_col) { return row_col != nrowcol{max_row_col}; }
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
+
+template <> struct fmt::formatter<ae::xlsx::cell_t> : fmt::formatter<ae::fmt_helper::default_formatter>
+{
+    template <typename FormatCtx> auto format(const ae::xlsx::cell_t& cell, FormatCtx& ctx)
+    {
+        std::visit(
+            [&ctx]<typename Content>(const Content& arg) {
+                if constexpr (std::is_same_v<Content, ae::xlsx::cell::empty>)
+                    ; // format_to(ctx.out(), "<empty>");
+                else if constexpr (std::is_same_v<Content, ae::xlsx::cell::error>)
+                    format_to(ctx.out(), "<error>");
+                else if constexpr (std::is_same_v<Content, bool>)
+                    format_to(ctx.out(), "{}", arg);
+                else if constexpr (std::is_same_v<Content, std::string> || std::is_same_v<Content, double> || std::is_same_v<Content, long>)
+                    format_to(ctx.out(), "{}", arg);
+                else if constexpr (std::is_same_v<Content, std::chrono::year_month_day>)
+                    format_to(ctx.out(), "{}", arg);
+                else
+                    format_to(ctx.out(), "<*unknown*>");
+            },
+            cell);
+        return ctx.out();
+    }
+};
+
+// ----------------------------------------------------------------------
+
+template <> struct fmt::formatter<ae::xlsx::nrow_t> : fmt::formatter<ae::fmt_helper::default_formatter>
+{
+    template <typename FormatCtx> auto format(ae::xlsx::nrow_t row, FormatCtx& ctx)
+    {
+        return format_to(ctx.out(), "{}", *row + 1);
+    }
+};
+
+template <> struct fmt::formatter<ae::xlsx::ncol_t> : fmt::formatter<ae::fmt_helper::default_formatter>
+{
+    template <typename FormatCtx> auto format(ae::xlsx::ncol_t col, FormatCtx& ctx)
+    {
+        auto coll = *col;
+        std::string nn;
+        while (true) {
+            nn.append(1, (coll % 26) + 'A');
+            if (coll < 26)
+                break;
+            coll = coll / 26 - 1;
+        }
+        std::reverse(std::begin(nn), std::end(nn));
+        return format_to(ctx.out(), "{}", nn);
+    }
+};
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include <unordered_set>
+
+#include "utils/static-regex.hh"
+#include "xlsx/cell.hh"
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    enum class cell_type : uint8_t { empty, error, boolean, string, real, integer, date };
+
+    // ----------------------------------------------------------------------
+
+    // Per-sheet storage of the cell strings, identical strings are stored once.
+    // Finalized arena has a shadow copy passed through ae::regex::fold()
+    // (ASCII uppercase), icase patterns match it without
+    // folding every character, offsets are the same in both.
+    class string_arena_t
+    {
+      public:
+        struct span_t
+        {
+            uint32_t offset{0};
+            uint32_t size{0};
+        };
+
+        string_arena_t() : index_{0, hash_t{this}, equal_t{this}} {}
+        string_arena_t(const string_arena_t&) = delete;
+        string_arena_t& operator=(const string_arena_t&) = delete;
+
+        std::string_view view(span_t span) const { return std::string_view{data_}.substr(span.offset, span.size); }
+        std::string_view folded(span_t span) const { return std::string_view{folded_}.substr(std::min(static_cast<size_t>(span.offset), folded_.size()), span.size); } // empty before finalize()
+        size_t size() const { return data_.size(); }
+
+        span_t intern(std::string_view str)
+        {
+            const auto start = data_.size();
+            data_.append(str);
+            return intern_tail(start);
+        }
+
+        // text is written directly to the end of the arena (see append), make it a string
+        span_t intern_tail(size_t start)
+        {
+            const span_t span{static_cast<uint32_t>(start), static_cast<uint32_t>(data_.size() - start)};
+            if (span.size == 0)
+                return span;
+            if (const auto found = index_.find(span); found != index_.end()) {
+                data_.resize(start); // already stored
+                return *found;
+            }
+            index_.insert(span);
+            return span;
+        }
+
+        void append(char sym) { data_.push_back(sym); }
+        auto appender() { return std::back_inserter(data_); }
+
+        // no more strings expected, release interning index, make folded copy
+        void finalize()
+        {
+            decltype(index_){0, hash_t{this}, equal_t{this}}.swap(index_);
+            data_.shrink_to_fit();
+            folded_.resize(data_.size());
+            ae::regex::fold(data_, folded_.data());
+        }
+
+      private:
+        struct hash_t
+        {
+            const string_arena_t* arena;
+            size_t operator()(span_t span) const { return std::hash<std::string_view>{}(arena->view(span)); }
+        };
+
+        struct equal_t
+        {
+            const string_arena_t* arena;
+            bool operator()(span_t s1, span_t s2) const { return arena->view(s1) == arena->view(s2); }
+        };
+
+        std::string data_{};
+        std::string folded_{};
+        std::unordered_set<span_t, hash_t, equal_t> index_;
+    };
+
+    // ----------------------------------------------------------------------
+
+    // 16 bytes instead of ~40 of cell_t, string content is in the sheet arena,
+    // text of other non-empty cells (as fmt::format("{}", cell)) is in the arena too
+    class compact_cell_t
+    {
+      public:
+        constexpr compact_cell_t() = default;
+
+        static compact_cell_t error() { return compact_cell_t{cell_type::error}; }
+        static compact_cell_t string(string_arena_t::span_t span)
+        {
+            compact_cell_t cell{cell_type::string};
+            cell.offset_ = span.offset;
+            cell.payload_.size = span.size;
+            return cell;
+        }
+        static compact_cell_t boolean(bool val)
+        {
+            compact_cell_t cell{cell_type::boolean};
+            cell.payload_.boolean = val;
+            return cell;
+        }
+        static compact_cell_t real(double val)
+        {
+            compact_cell_t cell{cell_type::real};
+            cell.payload_.real = val;
+            return cell;
+        }
+        static compact_cell_t integer(long val)
+        {
+            compact_cell_t cell{cell_type::integer};
+            cell.payload_.integer = val;
+            return cell;
+        }
+        static compact_cell_t date(const std::chrono::year_month_day& val)
+        {
+            compact_cell_t cell{cell_type::date};
+            cell.payload_.date = date_t{.year = static_cast<int16_t>(static_cast<int>(val.year())), .month = static_cast<uint8_t>(static_cast<unsigned>(val.month())), .day = static_cast<uint8_t>(static_cast<unsigned>(val.day()))};
+            return cell;
+        }
+
+        constexpr cell_type type() const { return type_; }
+        constexpr bool is_empty() const { return type_ == cell_type::empty; }
+        constexpr bool is_string() const { return type_ == cell_type::string; }
+        constexpr bool is_date() const { return type_ == cell_type::date; }
+
+        string_arena_t::span_t string_span() const { return {offset_, static_cast<uint32_t>(payload_.size)}; }
+        string_arena_t::span_t text_span() const { return is_string() ? string_span() : string_arena_t::span_t{offset_, text_size_}; }
+
+        // rendered text of a non-string cell
+        void set_text(string_arena_t::span_t span)
+        {
+            offset_ = span.offset;
+            text_size_ = static_cast<uint16_t>(span.size);
+        }
+        bool boolean() const { return payload_.boolean; }
+        double real() const { return payload_.real; }
+        long integer() const { return payload_.integer; }
+        std::chrono::year_month_day date() const { return std::chrono::year{payload_.date.year} / std::chrono::month{payload_.date.month} / std::chrono::day{payload_.date.day}; }
+
+      private:
+        struct date_t
+        {
+            int16_t year;
+            uint8_t month;
+            uint8_t day;
+        };
+
+        union payload_t {
+            uint64_t size; // string
+            double real;
+            long integer;
+            bool boolean;
+            date_t date;
+        };
+
+        cell_type type_{cell_type::empty};
+        uint8_t reserved_{0};
+        uint16_t text_size_{0}; // non-string cells: size of rendered text
+        uint32_t offset_{0};    // string or rendered text offset in the arena
+        payload_t payload_{0};
+
+        constexpr compact_cell_t(cell_type type) : type_{type} {}
+    };
+
+    static_assert(sizeof(compact_cell_t) == 16);
+
+    // ----------------------------------------------------------------------
+
+    class cell_view_t;
+
+    // row-major compact cells and their string arena
+    class cell_store_t
+    {
+      public:
+        nrow_t number_of_rows() const { return number_of_rows_; }
+        ncol_t number_of_columns() const { return number_of_columns_; }
+
+        void resize(nrow_t rows, ncol_t cols)
+        {
+            number_of_rows_ = rows;
+            number_of_columns_ = cols;
+            cells_.resize(*rows * *cols);
+        }
+
+        bool in_range(nrow_t row, ncol_t col) const { return row < number_of_rows_ && col < number_of_columns_; }
+        const compact_cell_t& at(nrow_t row, ncol_t col) const { return cells_[index(row, col)]; } // no range check
+        compact_cell_t& at(nrow_t row, ncol_t col) { return cells_[index(row, col)]; }
+
+        std::string_view string(const compact_cell_t& cell) const { return arena_.view(cell.string_span()); }
+        std::string_view text(const compact_cell_t& cell) const { return arena_.view(cell.text_span()); } // any cell, empty for empty cell
+        std::string_view folded(const compact_cell_t& cell) const { return arena_.folded(cell.text_span()); }
+
+        cell_view_t row(nrow_t row) const;    // empty view if outside
+        cell_view_t column(ncol_t col) const; // empty view if outside
+
+        cell_t get(const compact_cell_t& cell) const
+        {
+            switch (cell.type()) {
+                case cell_type::empty:
+                    return cell::empty{};
+                case cell_type::error:
+                    return cell::error{};
+                case cell_type::boolean:
+                    return cell.boolean();
+                case cell_type::string:
+                    return std::string{string(cell)};
+                case cell_type::real:
+                    return cell.real();
+                case cell_type::integer:
+                    return cell.integer();
+                case cell_type::date:
+                    return cell.date();
+            }
+            return cell::empty{};
+        }
+
+        cell_t get(nrow_t row, ncol_t col) const
+        {
+            if (in_range(row, col))
+                return get(at(row, col));
+            else
+                return cell::empty{};
+        }
+
+        // strings are interned in the arena, text of other cells is rendered
+        // once here, matching and comparing cells does not format them again
+        compact_cell_t compact(const cell_t& src)
+        {
+            auto cell = std::visit(
+                [this]<typename Content>(const Content& arg) {
+                    if constexpr (std::is_same_v<Content, cell::empty>)
+                        return compact_cell_t{};
+                    else if constexpr (std::is_same_v<Content, cell::error>)
+                        return compact_cell_t::error();
+                    else if constexpr (std::is_same_v<Content, bool>)
+                        return compact_cell_t::boolean(arg);
+                    else if constexpr (std::is_same_v<Content, std::string>)
+                        return compact_cell_t::string(arena_.intern(arg));
+                    else if constexpr (std::is_same_v<Content, double>)
+                        return compact_cell_t::real(arg);
+                    else if constexpr (std::is_same_v<Content, long>)
+                        return compact_cell_t::integer(arg);
+                    else if constexpr (std::is_same_v<Content, std::chrono::year_month_day>)
+                        return compact_cell_t::date(arg);
+                },
+                src);
+            if (!cell.is_empty() && !cell.is_string()) {
+                const auto start = arena_.size();
+                fmt::format_to(arena_.appender(), "{}", src);
+                cell.set_text(arena_.intern_tail(start));
+            }
+            return cell;
+        }
+
+        void set(nrow_t row, ncol_t col, const cell_t& src) { at(row, col) = compact(src); }
+
+        string_arena_t& arena() { return arena_; }
+        const string_arena_t& arena() const { return arena_; }
+
+        // all cells stored
+        void finalize() { arena_.finalize(); }
+
+      private:
+        nrow_t number_of_rows_{0};
+        ncol_t number_of_columns_{0};
+        std::vector<compact_cell_t> cells_{};
+        string_arena_t arena_{};
+
+        size_t index(nrow_t row, ncol_t col) const { return *row * *number_of_columns_ + *col; }
+    };
+
+    // ----------------------------------------------------------------------
+
+    // lightweight reference to a stored cell, no variant copy unless get() is called
+    class cell_ref_t
+    {
+      public:
+        cell_ref_t() = default;
+        cell_ref_t(const compact_cell_t& cell, const cell_store_t& store) : cell_{&cell}, store_{&store} {}
+
+        const compact_cell_t& compact() const { return *cell_; }
+        cell_type type() const { return cell_->type(); }
+        bool is_empty() const { return cell_->is_empty(); }
+        bool is_string() const { return cell_->is_string(); }
+        bool is_date() const { return cell_->is_date(); }
+        std::string_view str() const { return is_string() ? store_->string(*cell_) : std::string_view{}; } // empty for non-string cells
+        std::string_view text() const { return is_empty() ? std::string_view{} : store_->text(*cell_); }   // cell formatted with "{}"
+        std::string_view folded() const { return is_empty() ? std::string_view{} : store_->folded(*cell_); } // text() passed through ae::regex::fold()
+        cell_t get() const { return is_empty() ? cell_t{cell::empty{}} : store_->get(*cell_); }
+
+      private:
+        static inline constexpr const compact_cell_t empty_cell_{};
+
+        const compact_cell_t* cell_{&empty_cell_};
+        const cell_store_t* store_{nullptr};
+    };
+
+    // row or column of the store: cells at a fixed stride
+    class cell_view_t
+    {
+      public:
+        // position in the view, cell address is computed only when dereferenced:
+        // for a column first + size * stride would point past the end of the store
+        class iterator
+        {
+          public:
+            using difference_type = ssize_t;
+            using value_type = cell_ref_t;
+
+            iterator() = default;
+            iterator(const compact_cell_t* first, size_t pos, size_t stride, const cell_store_t* store) : first_{first}, pos_{pos}, stride_{stride}, store_{store} {}
+
+            cell_ref_t operator*() const { return cell_ref_t{first_[pos_ * stride_], *store_}; }
+            iterator& operator++()
+            {
+                ++pos_;
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                auto result = *this;
+                ++*this;
+                return result;
+            }
+            bool operator==(const iterator& rhs) const { return pos_ == rhs.pos_; }
+
+          private:
+            const compact_cell_t* first_{nullptr};
+            size_t pos_{0};
+            size_t stride_{1};
+            const cell_store_t* store_{nullptr};
+        };
+
+        cell_view_t() = default;
+        cell_view_t(const compact_cell_t* first, size_t size, size_t stride, const cell_store_t& store) : first_{first}, size_{size}, stride_{stride}, store_{&store} {}
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        cell_ref_t operator[](size_t pos) const { return cell_ref_t{first_[pos * stride_], *store_}; } // no range check
+        cell_ref_t at(size_t pos) const { return pos < size_ ? (*this)[pos] : cell_ref_t{}; }         // empty cell if outside
+
+        iterator begin() const { return iterator{first_, 0, stride_, store_}; }
+        iterator end() const { return iterator{first_, size_, stride_, store_}; }
+
+      private:
+        const compact_cell_t* first_{nullptr};
+        size_t size_{0};
+        size_t stride_{1};
+        const cell_store_t* store_{nullptr};
+    };
+
+    // ----------------------------------------------------------------------
+
+    inline cell_view_t cell_store_t::row(nrow_t row) const
+    {
+        if (row < number_of_rows_)
+            return cell_view_t{cells_.data() + index(row, ncol_t{0}), *number_of_columns_, 1, *this};
+        else
+            return {};
+    }
+
+    inline cell_view_t cell_store_t::column(ncol_t col) const
+    {
+        if (col < number_of_columns_ && number_of_rows_ > nrow_t{0})
+            return cell_view_t{cells_.data() + *col, *number_of_rows_, *number_of_columns_, *this};
+        else
+            return {};
+    }
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
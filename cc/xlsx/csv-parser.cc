@@ -20,31 +20,30 @@ ae::xlsx::v1::csv::Sheet::Sheet(const std::filesystem::path& filename)
 {
     const std::string src{ae::file::read(filename)};
 
-    const auto convert_cell = [&]() {};
+    // cell text is written directly to the end of the string arena
+    auto& arena = store_.arena();
+    std::vector<std::vector<compact_cell_t>> data;
+    xlsx::ncol_t columns{0};
+    size_t cell_start{arena.size()};
 
-    const auto new_cell = [&]() {
-        convert_cell();
-        data_.back().emplace_back(std::string{});
+    const auto finish_cell = [&]() {
+        data.back().push_back(compact_cell_t::string(arena.intern_tail(cell_start)));
+        cell_start = arena.size();
     };
 
+    const auto new_cell = [&]() { finish_cell(); };
+
     const auto new_row = [&]() {
-        convert_cell();
-        number_of_columns_ = std::max(number_of_columns_, xlsx::ncol_t{data_.back().size()});
-        data_.emplace_back().emplace_back(std::string{});
+        finish_cell();
+        columns = std::max(columns, xlsx::ncol_t{data.back().size()});
+        data.emplace_back();
     };
 
-    const auto append = [&](char sym) {
-        std::visit(
-            [sym]<typename Content>(Content& content) {
-                if constexpr (std::is_same_v<Content, std::string>)
-                    content.push_back(sym);
-            },
-            data_.back().back());
-    };
+    const auto append = [&](char sym) { arena.append(sym); };
 
     std::stack<enum state> states;
     states.push(state::cell);
-    data_.emplace_back().emplace_back(std::string{});
+    data.emplace_back();
     for (const char sym : src) {
         if (states.top() == state::escaped) {
             states.pop();
@@ -79,15 +78,19 @@ ae::xlsx::v1::csv::Sheet::Sheet(const std::filesystem::path& filename)
             }
         }
     }
+    finish_cell();
 
-    if (!data_.empty() && data_.back().size() <= 1 && number_of_columns_ > xlsx::ncol_t{1})
-        data_.erase(std::prev(data_.end()));
+    if (!data.empty() && data.back().size() <= 1 && columns > xlsx::ncol_t{1})
+        data.erase(std::prev(data.end()));
 
-    // normalize number of columns
-    for (auto& row : data_) {
-        while (row.size() < *number_of_columns_)
-            row.emplace_back(std::string{});
+    // normalize number of columns, missing cells are empty strings
+    store_.resize(xlsx::nrow_t{data.size()}, columns);
+    for (xlsx::nrow_t row{0}; row < number_of_rows(); ++row) {
+        const auto& src_row = data[*row];
+        for (xlsx::ncol_t col{0}; col < columns; ++col)
+            store_.at(row, col) = *col < src_row.size() ? src_row[*col] : compact_cell_t::string({});
     }
+    store_.finalize();
 
     AD_INFO("csv: rows: {} cols: {}", number_of_rows(), number_of_columns());
     // for (const auto& row : data_) {
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "xlsx/sheet.hh"
+#include "xlsx/compact-cell.hh"
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    // Cells stored row-major in a cell_store_t filled by the derived class while
+    // reading the file (xlnt worksheet, csv), cell() is then a plain index
+    class MaterializedSheet : public Sheet
+    {
+      public:
+        std::string name() const override { return name_; }
+        nrow_t number_of_rows() const override { return store_.number_of_rows(); }
+        ncol_t number_of_columns() const override { return store_.number_of_columns(); }
+        cell_t cell(nrow_t row, ncol_t col) const override { return store_.get(row, col); } // row and col are zero based, empty cell if outside (grepv looks one row below the region)
+        cell_view_t row(nrow_t row) const override { return store_.row(row); }
+        cell_view_t column(ncol_t col) const override { return store_.column(col); }
+
+      protected:
+        MaterializedSheet() = default; // derived class fills store_ and name_
+
+        std::string name_{};
+        cell_store_t store_{};
+    };
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,165 @@
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+#include "xlsx/sheet-arrow.hh"
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    // private data of a utf8 column array
+    struct arrow_column_t
+    {
+        std::vector<uint8_t> validity;
+        std::vector<int32_t> offsets{0};
+        std::string text{};
+        int64_t null_count{0};
+        std::array<const void*, 3> buffers{};
+    };
+
+    // private data of the struct array, columns are released by their own callbacks
+    // (consumer may move them out before releasing the struct)
+    struct arrow_struct_t
+    {
+        std::vector<ArrowArray> columns{};
+        std::vector<ArrowArray*> children{};
+        std::array<const void*, 1> buffers{nullptr}; // no validity bitmap, all rows are present
+    };
+
+    // private data of the struct schema, columns are released by their own callbacks,
+    // each column schema owns its name (private data of the column schema)
+    struct arrow_schema_t
+    {
+        std::vector<ArrowSchema> columns{};
+        std::vector<ArrowSchema*> children{};
+    };
+
+    inline void release_arrow_column(ArrowArray* array)
+    {
+        delete static_cast<arrow_column_t*>(array->private_data);
+        array->release = nullptr;
+    }
+
+    inline void release_arrow_struct(ArrowArray* array)
+    {
+        auto* data = static_cast<arrow_struct_t*>(array->private_data);
+        for (auto& column : data->columns) {
+            if (column.release != nullptr)
+                column.release(&column);
+        }
+        delete data;
+        array->release = nullptr;
+    }
+
+    inline void release_arrow_column_schema(ArrowSchema* schema)
+    {
+        delete static_cast<std::string*>(schema->private_data);
+        schema->release = nullptr;
+    }
+
+    inline void release_arrow_struct_schema(ArrowSchema* schema)
+    {
+        auto* data = static_cast<arrow_schema_t*>(schema->private_data);
+        for (auto& column : data->columns) {
+            if (column.release != nullptr)
+                column.release(&column);
+        }
+        delete data;
+        schema->release = nullptr;
+    }
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
+
+void ae::xlsx::v1::to_arrow(const Sheet& sheet, ArrowSchema& schema, ArrowArray& array)
+{
+    const auto number_of_rows = *sheet.number_of_rows(), number_of_columns = *sheet.number_of_columns();
+
+    std::vector<std::unique_ptr<arrow_column_t>> columns(number_of_columns);
+    for (auto& column : columns) {
+        column = std::make_unique<arrow_column_t>();
+        column->validity.resize((number_of_rows + 7) / 8, 0);
+        column->offsets.reserve(number_of_rows + 1);
+    }
+
+    for (nrow_t row{0}; row < sheet.number_of_rows(); ++row) {
+        const auto cells = sheet.row(row);
+        for (size_t col = 0; col < number_of_columns; ++col) {
+            auto& column = *columns[col];
+            if (const auto cell = cells.at(col); !cell.is_empty()) {
+                column.validity[*row / 8] |= static_cast<uint8_t>(1 << (*row % 8));
+                column.text.append(cell.text());
+                if (column.text.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max()))
+                    throw std::runtime_error{fmt::format("Sheet \"{}\": text of column {} is too long for arrow utf8", sheet.name(), col)};
+            }
+            else
+                ++column.null_count;
+            column.offsets.push_back(static_cast<int32_t>(column.text.size()));
+        }
+    }
+
+    // everything that allocates is done while columns and names are still owned by unique_ptrs,
+    // the hand-off to the raw arrow structs below does not throw
+    auto struct_data = std::make_unique<arrow_struct_t>();
+    struct_data->columns.resize(number_of_columns);
+    for (auto& column : struct_data->columns)
+        struct_data->children.push_back(&column);
+    auto schema_data = std::make_unique<arrow_schema_t>();
+    schema_data->columns.resize(number_of_columns);
+    for (auto& column : schema_data->columns)
+        schema_data->children.push_back(&column);
+    std::vector<std::unique_ptr<std::string>> names(number_of_columns);
+    for (size_t col = 0; col < number_of_columns; ++col)
+        names[col] = std::make_unique<std::string>(fmt::format("{}", col));
+
+    for (size_t col = 0; col < number_of_columns; ++col) {
+        auto* name = names[col].release();
+        schema_data->columns[col] = ArrowSchema{.format = "u",
+                                                .name = name->c_str(),
+                                                .metadata = nullptr,
+                                                .flags = ARROW_FLAG_NULLABLE,
+                                                .n_children = 0,
+                                                .children = nullptr,
+                                                .dictionary = nullptr,
+                                                .release = &release_arrow_column_schema,
+                                                .private_data = name};
+
+        auto* column = columns[col].release();
+        column->buffers = {column->null_count == 0 ? nullptr : column->validity.data(), column->offsets.data(), column->text.data()};
+        struct_data->columns[col] = ArrowArray{.length = static_cast<int64_t>(number_of_rows),
+                                               .null_count = column->null_count,
+                                               .offset = 0,
+                                               .n_buffers = 3,
+                                               .n_children = 0,
+                                               .buffers = column->buffers.data(),
+                                               .children = nullptr,
+                                               .dictionary = nullptr,
+                                               .release = &release_arrow_column,
+                                               .private_data = column};
+    }
+
+    schema = ArrowSchema{.format = "+s",
+                         .name = "",
+                         .metadata = nullptr,
+                         .flags = 0,
+                         .n_children = static_cast<int64_t>(number_of_columns),
+                         .children = schema_data->children.data(),
+                         .dictionary = nullptr,
+                         .release = &release_arrow_struct_schema,
+                         .private_data = schema_data.release()};
+    array = ArrowArray{.length = static_cast<int64_t>(number_of_rows),
+                       .null_count = 0,
+                       .offset = 0,
+                       .n_buffers = 1,
+                       .n_children = static_cast<int64_t>(number_of_columns),
+                       .buffers = struct_data->buffers.data(),
+                       .children = struct_data->children.data(),
+                       .dictionary = nullptr,
+                       .release = &release_arrow_struct,
+                       .private_data = struct_data.release()};
+
+} // ae::xlsx::v1::to_arrow
+
+// ----------------------------------------------------------------------
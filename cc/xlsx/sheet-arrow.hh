@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+
+#include "xlsx/sheet.hh"
+
+// ----------------------------------------------------------------------
+// Arrow C Data Interface, https://arrow.apache.org/docs/format/CDataInterface.html
+// ABI-stable struct definitions from the spec, no arrow library needed.
+// ----------------------------------------------------------------------
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema
+{
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray
+{
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    // Whole sheet as a struct array (record batch): one nullable utf8 column
+    // per sheet column named by its number ("0", "1", ...), one element per
+    // row, cell text as returned by Sheet::text(), null for empty cells.
+    // Cells are read in one pass, text is copied, schema and array do not
+    // refer to the sheet and are freed by their release callbacks. Children
+    // of both may be moved out and released separately, as the C data
+    // interface allows.
+    void to_arrow(const Sheet& sheet, ArrowSchema& schema, ArrowArray& array);
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
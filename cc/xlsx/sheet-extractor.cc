@@ -1,8 +1,9 @@
 #include "ext/range-v3.hh"
 #include "utils/log.hh"
-#include "utils/regex.hh"
+#include "utils/static-regex.hh"
 #include "utils/string.hh"
 #include "xlsx/sheet-extractor.hh"
+#include "xlsx/cell-index.hh"
 #include "xlsx/error.hh"
 
 // #include "acmacs-base/enumerate.hh"
@@ -12,91 +13,94 @@
 
 // ----------------------------------------------------------------------
 
-#pragma GCC diagnostic push
-#ifdef __clang__
-#pragma GCC diagnostic ignored "-Wglobal-constructors"
-#pragma GCC diagnostic ignored "-Wexit-time-destructors"
-#endif
-
-constexpr auto regex_icase = std::regex::icase | std::regex::ECMAScript | std::regex::optimize;
+// patterns are compiled at compile time, all ignore case, see utils/static-regex.hh
 
 // static const std::regex re_ac_ignore_sheet{"^AC-IGNORE", regex_icase};
 
 // static const std::regex re_table_title_crick{R"(^Table\s+[XY0-9-]+\s*\.\s*Antigenic analys[ie]s of influenza ([AB](?:\(H3N2\)|\(H1N1\)pdm09)?)\s*viruses\s*-?\s*\(?(Plaque\s+Reduction\s+Neutralisation\s*\(MDCK-SIAT\)|(?:Victoria|Yamagata)\s+lineage)?\)?\s*\(?(20[0-2][0-9]-[01][0-9]-[0-3][0-9])\)?)", regex_icase};
 
 // static const std::regex re_antigen_passage{"^(MDCK|QMC|C|SIAT|S|E|HCK|X)[0-9X]", regex_icase};
-static const std::regex re_serum_passage{"^(MDCK|QMC|C|SIAT|S|E|HCK|CELL|EGG)", regex_icase};
+static constexpr ae::regex::static_regex<"^(MDCK|QMC|C|SIAT|S|E|HCK|CELL|EGG)"> re_serum_passage;
 
 // static const std::regex re_CDC_antigen_passage{R"(^((?:MDCK|SIAT|S|E|HCK|QMC|C|X)[0-9X][^\s\(]*)\s*(?:\(([\d/]+)\))?[A-Z]*$)", regex_icase};
-static const std::regex re_CDC_antigen_lab_id{"^[0-9]{10}$", regex_icase};
-static const std::regex re_CDC_serum_index{"^([A-Z]|EGG)$", regex_icase}; // EGG is excel auto-correction artefact
-static const std::regex re_CDC_serum_control{R"(^\s*SERUM\s+CONTROL\s*$)", regex_icase};
-static const std::regex re_CDC_lot_label{R"(^\s*LOT\s*#?\s*$)", regex_icase};
-static const std::regex re_CDC_date_label{R"(^\s*DATE\s*$)", regex_icase};
-static const std::regex re_CDC_treated_label{R"(^\s*TREATED\s*$)", regex_icase};
-static const std::regex re_CDC_date_treated_label{R"(^\s*DATE\s+TREATED\s*$)", regex_icase};
-static const std::regex re_CDC_species_label{R"(^\s*SPECIES\s*$)", regex_icase};
-static const std::regex re_CDC_boosted_label{R"(^\s*BOOSTED\s*$)", regex_icase};
-static const std::regex re_CDC_conc_label{R"(^\s*CONC\s*$)", regex_icase};
-static const std::regex re_CDC_dilut_label{R"(^\s*DILUT\s*$)", regex_icase};
-static const std::regex re_CDC_passage_label{R"(^\s*PASSAGE\s*$)", regex_icase};
-static const std::regex re_CDC_pool_label{R"(^\s*POOL\s*$)", regex_icase};
-static const std::regex re_CDC_titer_label{R"(^\s*(BACK)?\s*TITER\b)", regex_icase};
-static const std::regex re_CDC_ha_group_label{R"(^\s*HA\s*GROUP\b)", regex_icase};
-static const std::regex re_CDC_antigen_control{R"(\bCONTROL\b)", regex_icase};
-
-static const std::regex re_AC21_serum_index{R"(^[0-9]+$)", regex_icase};
-static const std::regex re_AC21_ID_label{R"(^\s*ID\s*$)", regex_icase};
-static const std::regex re_AC21_serum_label{R"(^\s*serum\s*$)", regex_icase};
-static const std::regex re_AC21_date_label{R"(^\s*date\s*$)", regex_icase};
-static const std::regex re_AC21_species_label{R"(^\s*SPECIES\s*$)", regex_icase};
-static const std::regex re_AC21_treat_label{R"(^\s*treat\.?\s*$)", regex_icase};
-static const std::regex re_AC21_type_label{R"(^\s*TYPE\s*$)", regex_icase};
-static const std::regex re_AC21_batch_label{R"(^\s*BATCH\s*#?\s*$)", regex_icase};
-static const std::regex re_AC21_comment_label{R"(^\s*COMMENT\s*$)", regex_icase};
-static const std::regex re_AC21_empty{R"(^\s*$)", regex_icase};
-
-static const std::regex re_CRICK_serum_name_1{"^([AB]/[A-Z '_-]+|NYMC\\s+X-[0-9]+[A-Z]*)$", regex_icase};
-static const std::regex re_CRICK_serum_name_2{"^[A-Z0-9-/]+$", regex_icase};
+static constexpr ae::regex::static_regex<"^[0-9]{10}$"> re_CDC_antigen_lab_id;
+static constexpr ae::regex::static_regex<"^([A-Z]|EGG)$"> re_CDC_serum_index; // EGG is excel auto-correction artefact
+static constexpr ae::regex::static_regex<R"(^\s*SERUM\s+CONTROL\s*$)"> re_CDC_serum_control;
+static constexpr ae::regex::static_regex<R"(^\s*DATE\s*$)"> re_CDC_date_label;
+// serum column labels, order matches cdc_serum_label
+static constexpr ae::regex::set<R"(^\s*LOT\s*#?\s*$)", R"(^\s*SPECIES\s*$)", R"(^\s*BOOSTED\s*$)", R"(^\s*CONC\s*$)", R"(^\s*DILUT\s*$)", R"(^\s*PASSAGE\s*$)", R"(^\s*POOL\s*$)",
+                                R"(^\s*DATE\s+TREATED\s*$)", R"(^\s*TREATED\s*$)">
+    re_CDC_serum_labels;
+enum cdc_serum_label : size_t { cdc_lot, cdc_species, cdc_boosted, cdc_conc, cdc_dilut, cdc_passage, cdc_pool, cdc_date_treated, cdc_treated };
+static constexpr ae::regex::static_regex<R"(^\s*(BACK)?\s*TITER\b)"> re_CDC_titer_label;
+static constexpr ae::regex::static_regex<R"(^\s*HA\s*GROUP\b)"> re_CDC_ha_group_label;
+static constexpr ae::regex::static_regex<R"(\bCONTROL\b)"> re_CDC_antigen_control;
+
+static constexpr ae::regex::static_regex<R"(^[0-9]+$)"> re_AC21_serum_index;
+#define pattern_AC21_ID_label R"(^\s*ID\s*$)"
+static constexpr ae::regex::static_regex<pattern_AC21_ID_label> re_AC21_ID_label;
+static constexpr ae::regex::static_regex<R"(^\s*serum\s*$)"> re_AC21_serum_label;
+static constexpr ae::regex::static_regex<R"(^\s*date\s*$)"> re_AC21_date_label;
+static constexpr ae::regex::static_regex<R"(^\s*treat\.?\s*$)"> re_AC21_treat_label;
+static constexpr ae::regex::static_regex<R"(^\s*TYPE\s*$)"> re_AC21_type_label;
+static constexpr ae::regex::static_regex<R"(^\s*BATCH\s*#?\s*$)"> re_AC21_batch_label;
+static constexpr ae::regex::static_regex<R"(^\s*COMMENT\s*$)"> re_AC21_comment_label;
+// serum column labels below re_AC21_serum_label, order matches ac21_serum_label
+static constexpr ae::regex::set<pattern_AC21_ID_label, R"(^\s*SPECIES\s*$)"> re_AC21_serum_labels;
+enum ac21_serum_label : size_t { ac21_id, ac21_species };
+static constexpr ae::regex::static_regex<R"(^\s*$)"> re_AC21_empty;
+
+static constexpr ae::regex::static_regex<"^([AB]/[A-Z '_-]+|NYMC\\s+X-[0-9]+[A-Z]*)$"> re_CRICK_serum_name_1;
+static constexpr ae::regex::static_regex<"^[A-Z0-9-/]+$"> re_CRICK_serum_name_2;
 #define pattern_CRICK_serum_id "F[0-9]+/[0-2][0-9]"
-static const std::regex re_CRICK_serum_id{R"(^(?:[A-Z\s]+\s+)?\s*(F[0-9]+/[0-2][0-9]|SH[\s\d,/]+)(?:\*(\d)(?:,\d)?)?$)", regex_icase};
-static const std::regex re_CRICK_less_than{R"(^\s*<\s*=\s*(<\d+)\s*$)", regex_icase};
-static const std::regex re_CRICK_less_than_2{R"(^Superscripts.*\s+(\d)\s*<\s*=\s*(<\d+)\s*$)", regex_icase};
-static const std::regex re_CRICK_less_than_multi{R"(^\s*\d\s*<\s*=\s*<\d+\s*[;,])", regex_icase};
-static const std::regex re_CRICK_less_than_multi_entry{R"(^\s*(\d)\s*<\s*=\s*(<\d+)\s*$)", regex_icase};
-
-static const std::regex re_CRICK_prn_2fold{"^2-fold$", regex_icase};
-static const std::regex re_CRICK_prn_read{"^read$", regex_icase};
-
-static const std::regex re_NIID_serum_name{R"(^\s*(?:\d+[A-Z]\s+)?)"           // [clade]
-                                           R"(([A-Z][A-Z\d\s\-_\./\(\)]+)\s+)" // name with reassortant $1
-                                           // R"((?:(EGG|CELL|HCK)\s+)?)"         // passage type (sometimes absent for reassortants) $2
-                                           // R"((?:NIID\s+)?)"                   // NIID artefact
-                                           R"(NO\s*\.\s*([\d\-]+)$)",          // serum_id $2
-                                           regex_icase};
-static const std::regex re_NIID_serum_passage{R"(\s*(EGG|CELL|HCK)?\s*(?:NIID)?\s*$)", regex_icase};
-
-static const std::regex re_NIID_serum_name_fix{R"(\s*([\-/])\s*)", regex_icase}; // remove spaces around - and /
-static const std::regex re_NIID_lab_id_label{"^\\s*NIID-ID\\s*$", regex_icase};
-static const std::regex re_NIID_serum_name_row_non_serum_label{R"((HA\s*group))", regex_icase};
-
-static const std::regex re_VIDRL_antigen_lab_id{"^(SL|VW)[0-9]{8}$", regex_icase};
-static const std::regex re_VIDRL_antigen_date_column_title{"^\\s*Sample\\s*Date\\s*$", regex_icase};
-static const std::regex re_VIDRL_antigen_lab_id_column_title{"^\\s*VW\\s*$", regex_icase};
-static const std::regex re_VIDRL_serum_name{"^(?:[AB]/)?([A-Z][A-Z ]+)/?([0-9]+)(?:_.*)?$", regex_icase}; // optional mutant info at the end
+static constexpr ae::regex::static_regex<R"(^(?:[A-Z\s]+\s+)?\s*(F[0-9]+/[0-2][0-9]|SH[\s\d,/]+)(?:\*(\d)(?:,\d)?)?$)"> re_CRICK_serum_id;
+static constexpr ae::regex::static_regex<R"(^\s*<\s*=\s*(<\d+)\s*$)"> re_CRICK_less_than;
+static constexpr ae::regex::static_regex<R"(^Superscripts.*\s+(\d)\s*<\s*=\s*(<\d+)\s*$)"> re_CRICK_less_than_2;
+static constexpr ae::regex::static_regex<R"(^\s*\d\s*<\s*=\s*<\d+\s*[;,])"> re_CRICK_less_than_multi;
+static constexpr ae::regex::static_regex<R"(^\s*(\d)\s*<\s*=\s*(<\d+)\s*$)"> re_CRICK_less_than_multi_entry;
+
+static constexpr ae::regex::static_regex<"^2-fold$"> re_CRICK_prn_2fold;
+static constexpr ae::regex::static_regex<"^read$"> re_CRICK_prn_read;
+
+static constexpr ae::regex::static_regex<R"(^\s*(?:\d+[A-Z]\s+)?)"           // [clade]
+                                          R"(([A-Z][A-Z\d\s\-_\./\(\)]+)\s+)" // name with reassortant $1
+                                          // R"((?:(EGG|CELL|HCK)\s+)?)"         // passage type (sometimes absent for reassortants) $2
+                                          // R"((?:NIID\s+)?)"                   // NIID artefact
+                                          R"(NO\s*\.\s*([\d\-]+)$)"           // serum_id $2
+                                          >
+    re_NIID_serum_name;
+static constexpr ae::regex::static_regex<R"(\s*(EGG|CELL|HCK)?\s*(?:NIID)?\s*$)"> re_NIID_serum_passage;
+
+static constexpr ae::regex::static_regex<R"(\s*([\-/])\s*)"> re_NIID_serum_name_fix; // remove spaces around - and /
+static constexpr ae::regex::static_regex<"^\\s*NIID-ID\\s*$"> re_NIID_lab_id_label;
+static constexpr ae::regex::static_regex<R"((HA\s*group))"> re_NIID_serum_name_row_non_serum_label;
+
+static constexpr ae::regex::static_regex<"^(SL|VW)[0-9]{8}$"> re_VIDRL_antigen_lab_id;
+static constexpr ae::regex::static_regex<"^\\s*Sample\\s*Date\\s*$"> re_VIDRL_antigen_date_column_title;
+static constexpr ae::regex::static_regex<"^\\s*VW\\s*$"> re_VIDRL_antigen_lab_id_column_title;
+static constexpr ae::regex::static_regex<"^(?:[AB]/)?([A-Z][A-Z ]+)/?([0-9]+)(?:_.*)?$"> re_VIDRL_serum_name; // optional mutant info at the end
 #define pattern_VIDRL_serum_id "[AF][0-9][0-9][0-9][0-9](?:-[0-9]+D)?"
-static const std::regex re_VIDRL_serum_id{"^(" pattern_VIDRL_serum_id "|" pattern_CRICK_serum_id ")$", regex_icase};
-static const std::regex re_VIDRL_serum_id_with_days{"^[AF][0-9][0-9][0-9][0-9]-[0-9]+D$", regex_icase};
+static constexpr ae::regex::static_regex<"^(" pattern_VIDRL_serum_id "|" pattern_CRICK_serum_id ")$"> re_VIDRL_serum_id;
+static constexpr ae::regex::static_regex<"^[AF][0-9][0-9][0-9][0-9]-[0-9]+D$"> re_VIDRL_serum_id_with_days;
 
-static const std::regex re_human_who_serum{R"(^\s*(.*(HUMAN|WHO|NORMAL)|GOAT|POST? VAX)\b)", regex_icase}; // "POST VAX" is in VIDRL H3 HI 2021
+static constexpr ae::regex::static_regex<R"(^\s*(.*(HUMAN|WHO|NORMAL)|GOAT|POST? VAX)\b)"> re_human_who_serum; // "POST VAX" is in VIDRL H3 HI 2021
 
-#pragma GCC diagnostic pop
 
 static const std::string_view LineageVictoria{"VICTORIA"};
 static const std::string_view LineageYamagata{"YAMAGATA"};
 
 // ----------------------------------------------------------------------
 
+// matches of one pattern of a regex set
+static inline std::vector<ae::xlsx::cell_match_t> matches_of_pattern(const std::vector<ae::xlsx::cell_match_t>& matches, size_t pattern_no)
+{
+    std::vector<ae::xlsx::cell_match_t> result;
+    std::copy_if(std::begin(matches), std::end(matches), std::back_inserter(result), [pattern_no](const auto& match) { return match.pattern_no == pattern_no; });
+    return result;
+}
+
+// ----------------------------------------------------------------------
+
 std::shared_ptr<ae::xlsx::Extractor> ae::xlsx::v1::extractor_factory(std::shared_ptr<Sheet> sheet, const detect_result_t& detected, Extractor::warn_if_not_found winf)
 {
     try {
@@ -167,6 +171,64 @@ std::shared_ptr<ae::xlsx::Extractor> ae::xlsx::v1::extractor_factory(std::shared
 
 // ----------------------------------------------------------------------
 
+#define extractor_pattern(re) extractor_pattern_t{#re, re.pattern(), re}
+
+std::vector<ae::xlsx::extractor_pattern_t> ae::xlsx::v1::extractor_patterns()
+{
+    std::vector<extractor_pattern_t> result{
+        extractor_pattern(re_serum_passage),
+        extractor_pattern(re_CDC_antigen_lab_id),
+        extractor_pattern(re_CDC_serum_index),
+        extractor_pattern(re_CDC_serum_control),
+        extractor_pattern(re_CDC_date_label),
+        extractor_pattern(re_CDC_titer_label),
+        extractor_pattern(re_CDC_ha_group_label),
+        extractor_pattern(re_CDC_antigen_control),
+        extractor_pattern(re_AC21_serum_index),
+        extractor_pattern(re_AC21_ID_label),
+        extractor_pattern(re_AC21_serum_label),
+        extractor_pattern(re_AC21_date_label),
+        extractor_pattern(re_AC21_treat_label),
+        extractor_pattern(re_AC21_type_label),
+        extractor_pattern(re_AC21_batch_label),
+        extractor_pattern(re_AC21_comment_label),
+        extractor_pattern(re_AC21_empty),
+        extractor_pattern(re_CRICK_serum_name_1),
+        extractor_pattern(re_CRICK_serum_name_2),
+        extractor_pattern(re_CRICK_serum_id),
+        extractor_pattern(re_CRICK_less_than),
+        extractor_pattern(re_CRICK_less_than_2),
+        extractor_pattern(re_CRICK_less_than_multi),
+        extractor_pattern(re_CRICK_less_than_multi_entry),
+        extractor_pattern(re_CRICK_prn_2fold),
+        extractor_pattern(re_CRICK_prn_read),
+        extractor_pattern(re_NIID_serum_name),
+        extractor_pattern(re_NIID_serum_passage),
+        extractor_pattern(re_NIID_serum_name_fix),
+        extractor_pattern(re_NIID_lab_id_label),
+        extractor_pattern(re_NIID_serum_name_row_non_serum_label),
+        extractor_pattern(re_VIDRL_antigen_lab_id),
+        extractor_pattern(re_VIDRL_antigen_date_column_title),
+        extractor_pattern(re_VIDRL_antigen_lab_id_column_title),
+        extractor_pattern(re_VIDRL_serum_name),
+        extractor_pattern(re_VIDRL_serum_id),
+        extractor_pattern(re_VIDRL_serum_id_with_days),
+        extractor_pattern(re_human_who_serum),
+    };
+    const auto add_set = [&result](std::string_view name, const auto& set) {
+        for (size_t pattern_no = 0; pattern_no < set.size(); ++pattern_no)
+            result.push_back(extractor_pattern_t{name, set.pattern(pattern_no), set[pattern_no]});
+    };
+    add_set("re_CDC_serum_labels", re_CDC_serum_labels);
+    add_set("re_AC21_serum_labels", re_AC21_serum_labels);
+    return result;
+
+} // ae::xlsx::v1::extractor_patterns
+
+#undef extractor_pattern
+
+// ----------------------------------------------------------------------
+
 std::string_view ae::xlsx::v1::Extractor::subtype_without_lineage() const
 {
     if (subtype_ == "A(H1N1)PDM09")
@@ -199,7 +261,7 @@ std::string ae::xlsx::v1::Extractor::subtype_short() const
 
 // ----------------------------------------------------------------------
 
-ae::xlsx::v1::antigen_fields_t ae::xlsx::v1::Extractor::antigen(size_t ag_no) const
+ae::xlsx::v1::antigen_fields_t ae::xlsx::v1::Extractor::make_antigen(size_t ag_no) const
 {
     const auto make = [this, row = antigen_rows().at(ag_no)](std::optional<ncol_t> col) -> std::string {
         if (col.has_value()) {
@@ -216,7 +278,7 @@ ae::xlsx::v1::antigen_fields_t ae::xlsx::v1::Extractor::antigen(size_t ag_no) co
         .lab_id = make_lab_id(make(antigen_lab_id_column()))     //
     };
 
-} // ae::xlsx::v1::Extractor::antigen
+} // ae::xlsx::v1::Extractor::make_antigen
 
 // ----------------------------------------------------------------------
 
@@ -230,10 +292,28 @@ void ae::xlsx::v1::Extractor::preprocess(warn_if_not_found winf)
     find_serum_rows(winf);
     exclude_control_sera(winf); // remove human, WHO, pooled sera
 
+    antigens_.clear();
+    antigens_.reserve(number_of_antigens());
+    for (const auto ag_no : range_from_0_to(number_of_antigens()))
+        antigens_.push_back(make_antigen(ag_no));
+    make_lookup_tables();
+    make_sera();
+
 } // ae::xlsx::v1::Extractor::preprocess
 
 // ----------------------------------------------------------------------
 
+void ae::xlsx::v1::Extractor::make_sera()
+{
+    sera_.clear();
+    sera_.reserve(number_of_sera());
+    for (const auto sr_no : range_from_0_to(number_of_sera()))
+        sera_.push_back(make_serum(sr_no));
+
+} // ae::xlsx::v1::Extractor::make_sera
+
+// ----------------------------------------------------------------------
+
 template <ae::xlsx::NRowCol nrowcol> using number_ranges = std::vector<std::pair<nrowcol, nrowcol>>;
 
 template <ae::xlsx::NRowCol nrowcol> inline number_ranges<nrowcol> make_ranges(const std::vector<nrowcol>& numbers)
@@ -302,26 +382,70 @@ void ae::xlsx::v1::Extractor::check_export_possibility() const // throws Error i
 
 // ----------------------------------------------------------------------
 
+namespace ae::xlsx::inline v1
+{
+    // numbers as integers (crick sometimes has real number titers), other cells as rendered
+    inline void append_titer_text(std::string& target, const cell_ref_t& cell, bool remove_spaces)
+    {
+        switch (cell.type()) {
+            case cell_type::string:
+                if (remove_spaces) // NIID has titers with spaces, e.g. "< 10"
+                    std::copy_if(std::begin(cell.str()), std::end(cell.str()), std::back_inserter(target), [](char cc) { return !std::isspace(static_cast<unsigned char>(cc)); });
+                else
+                    target.append(cell.str());
+                break;
+            case cell_type::real:
+                fmt::format_to(std::back_inserter(target), "{}", std::lround(cell.compact().real()));
+                break;
+            default:
+                target.append(cell.text());
+                break;
+        }
+    }
+
+    // replaces the titer appended to target starting at start
+    inline void replace_titer(std::string& target, size_t start, std::string_view titer)
+    {
+        target.resize(start);
+        target.append(titer);
+    }
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
+
 std::string ae::xlsx::v1::Extractor::titer(size_t ag_no, size_t sr_no) const
 {
-    const auto cell = sheet().cell(antigen_rows().at(ag_no), serum_columns().at(sr_no));
-    return std::visit(
-        [&cell]<typename Content>(const Content& cont) -> std::string {
-            if constexpr (std::is_same_v<Content, std::string>)
-                return ae::string::remove_spaces(cont); // NIID has titers with spaces, e.g. "< 10"
-            else if constexpr (std::is_same_v<Content, long>)
-                return fmt::format("{}", cont);
-            else if constexpr (std::is_same_v<Content, double>)
-                return fmt::format("{}", std::lround(cont)); // crick sometimes has real number titers
-            else
-                return fmt::format("{}", cell);
-        },
-        cell);
+    std::string result;
+    append_titer(result, sr_no, sheet().row(antigen_rows().at(ag_no)));
+    return result;
 
 } // ae::xlsx::v1::Extractor::titer
 
 // ----------------------------------------------------------------------
 
+ae::xlsx::v1::titer_matrix_t ae::xlsx::v1::Extractor::titers() const
+{
+    titer_matrix_t matrix{number_of_antigens(), number_of_sera()};
+    for (const auto row : antigen_rows()) {
+        const auto antigen_row = sheet().row(row);
+        for (const auto sr_no : range_from_0_to(number_of_sera()))
+            matrix.add([this, sr_no, &antigen_row](std::string& target) { append_titer(target, sr_no, antigen_row); });
+    }
+    return matrix;
+
+} // ae::xlsx::v1::Extractor::titers
+
+// ----------------------------------------------------------------------
+
+void ae::xlsx::v1::Extractor::append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const
+{
+    append_titer_text(target, antigen_row.at(*serum_columns().at(sr_no)), true);
+
+} // ae::xlsx::v1::Extractor::append_titer
+
+// ----------------------------------------------------------------------
+
 void ae::xlsx::v1::Extractor::find_titers(warn_if_not_found winf)
 {
     std::vector<std::pair<nrow_t, range<ncol_t>>> rows;
@@ -419,9 +543,18 @@ void ae::xlsx::v1::Extractor::remove_redundant_antigen_rows(warn_if_not_found wi
 
 template <typename F> inline std::optional<ae::xlsx::ncol_t> find_column(const ae::xlsx::Sheet& sheet, const std::vector<ae::xlsx::nrow_t>& rows, F valid_cell)
 {
+    const auto& index = sheet.type_index();
+    const auto rows_mask = index.rows_mask(rows);
     std::vector<std::tuple<ae::xlsx::ncol_t, ssize_t>> number_per_column;
     for (ae::xlsx::ncol_t col{0}; col < sheet.number_of_columns(); ++col) {
-        if (const auto number = ranges::count_if(rows, [col, &valid_cell, &sheet](ae::xlsx::nrow_t row) { return valid_cell(sheet.cell(row, col)); }); number > 0)
+        // valid_cell is called for non-empty cells in the given rows only
+        ssize_t number{0};
+        const auto cells = sheet.column(col);
+        (rows_mask & index.column(col, ae::xlsx::cell_kind::non_empty)).for_each([&cells, &valid_cell, &number](size_t row) {
+            if (valid_cell(cells[row].get()))
+                ++number;
+        });
+        if (number > 0)
             number_per_column.emplace_back(col, number);
     }
     if (!number_per_column.empty())
@@ -482,7 +615,7 @@ void ae::xlsx::v1::Extractor::find_antigen_lab_id_column(warn_if_not_found winf)
 
 // ----------------------------------------------------------------------
 
-std::optional<ae::xlsx::v1::nrow_t> ae::xlsx::v1::Extractor::find_serum_row(const std::regex& re, std::string_view row_name, warn_if_not_found winf, std::optional<nrow_t> ignore) const
+std::optional<ae::xlsx::v1::nrow_t> ae::xlsx::v1::Extractor::find_serum_row(const ae::regex::program_ref_t& re, std::string_view row_name, warn_if_not_found winf, std::optional<nrow_t> ignore) const
 {
     std::optional<nrow_t> found;
     for (nrow_t row{1}; row < antigen_rows()[0]; ++row) {
@@ -513,7 +646,7 @@ bool ae::xlsx::v1::Extractor::is_control_serum_cell(const cell_t& cell) const
 {
     if (is_string(cell)) {
         const auto text = fmt::format("{}", cell);
-        if (std::regex_search(text, re_human_who_serum))
+        if (ae::regex::search(text, re_human_who_serum))
             return true;
     }
     return false;
@@ -591,14 +724,14 @@ ae::xlsx::v1::ExtractorCDC::ExtractorCDC(std::shared_ptr<Sheet> a_sheet)
 
 // ----------------------------------------------------------------------
 
-std::string ae::xlsx::v1::ExtractorCDC::titer(size_t ag_no, size_t sr_no) const
+void ae::xlsx::v1::ExtractorCDC::append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const
 {
-    auto result = Extractor::titer(ag_no, sr_no);
-    if (result == "5")
-        result = "<10";
-    return result;
+    const auto start = target.size();
+    Extractor::append_titer(target, sr_no, antigen_row);
+    if (std::string_view{target}.substr(start) == "5")
+        replace_titer(target, start, "<10");
 
-} // ae::xlsx::v1::ExtractorCDC::titer
+} // ae::xlsx::v1::ExtractorCDC::append_titer
 
 // ----------------------------------------------------------------------
 
@@ -630,24 +763,37 @@ void ae::xlsx::v1::ExtractorCDC::remove_redundant_antigen_rows(warn_if_not_found
 
 // ----------------------------------------------------------------------
 
-bool ae::xlsx::v1::ExtractorCDC::serum_index_matches(const cell_t& at_row, const cell_t& at_column) const
+std::string_view ae::xlsx::v1::ExtractorCDC::serum_index_key(const cell_ref_t& cell) const
 {
-    if (is_empty(at_row) || is_empty(at_column))
-        return false;
-    return fmt::format("{}", at_row)[0] == fmt::format("{}", at_column)[0];
+    if (cell.is_empty())
+        return {};
+    return cell.text().substr(0, 1); // EGG (excel auto-correction artefact) is E
+
+} // ae::xlsx::v1::ExtractorCDC::serum_index_key
+
+// ----------------------------------------------------------------------
 
-} // ae::xlsx::v1::ExtractorCDC::serum_index_matches
+void ae::xlsx::v1::ExtractorCDC::make_serum_index_rows()
+{
+    serum_index_rows_.clear();
+    if (serum_index_row_.has_value() && serum_index_column_.has_value() && !serum_rows_.empty()) {
+        const auto index_column = sheet().column(*serum_index_column_);
+        for (nrow_t row{serum_rows_[0]}; row < sheet().number_of_rows(); ++row) {
+            if (const auto key = serum_index_key(index_column.at(*row)); !key.empty())
+                serum_index_rows_.try_emplace(std::string{key}, row);
+        }
+    }
+
+} // ae::xlsx::v1::ExtractorCDC::make_serum_index_rows
 
 // ----------------------------------------------------------------------
 
 ae::xlsx::v1::nrow_t ae::xlsx::v1::ExtractorCDC::find_serum_row_by_col(ncol_t col) const
 {
     if (serum_index_row_.has_value() && serum_index_column_.has_value()) {
-        if (const auto serum_index = sheet().cell(*serum_index_row_, col); !is_empty(serum_index)) {
-            for (nrow_t row{serum_rows_[0]}; row < sheet().number_of_rows(); ++row) {
-                if (const auto index_cell = sheet().cell(row, *serum_index_column_); serum_index_matches(serum_index, index_cell))
-                    return row;
-            }
+        if (const auto key = serum_index_key(sheet().row(*serum_index_row_).at(*col)); !key.empty()) {
+            if (const auto found = serum_index_rows_.find(std::string{key}); found != serum_index_rows_.end())
+                return found->second;
         }
     }
     AD_WARNING("{} cannot find serum for column {}", extractor_name(), col);
@@ -657,7 +803,7 @@ ae::xlsx::v1::nrow_t ae::xlsx::v1::ExtractorCDC::find_serum_row_by_col(ncol_t co
 
 // ----------------------------------------------------------------------
 
-ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorCDC::serum(size_t sr_no) const
+ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorCDC::make_serum(size_t sr_no) const
 {
     if (const auto row = find_serum_row_by_col(serum_columns().at(sr_no)); valid(row)) {
 
@@ -682,12 +828,12 @@ ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorCDC::serum(size_t sr_no) con
                 .species = make(serum_species_column_),               //
                 .conc = make(serum_conc_column_),                     //
                 .dilut = make(serum_dilut_column_),                   //
-                .boosted = serum_boosted_column_.has_value() && !is_empty(sheet().cell(row, *serum_boosted_column_)) && fmt::format("{}", sheet().cell(row, *serum_boosted_column_))[0] == 'Y'};
+                .boosted = serum_boosted_column_.has_value() && sheet().text(row, *serum_boosted_column_).starts_with('Y')};
     }
     else
         return {};
 
-} // ae::xlsx::v1::ExtractorCDC::serum
+} // ae::xlsx::v1::ExtractorCDC::make_serum
 
 // ----------------------------------------------------------------------
 
@@ -696,12 +842,13 @@ void ae::xlsx::v1::ExtractorCDC::find_serum_rows(warn_if_not_found winf)
     find_serum_index_row(winf, re_CDC_serum_index);
     find_serum_name_column(winf, re_CDC_serum_index);
     find_serum_columns(winf);
+    make_serum_index_rows();
 
 } // ae::xlsx::v1::ExtractorCDC::find_serum_rows
 
 // ----------------------------------------------------------------------
 
-void ae::xlsx::v1::ExtractorCDC::find_serum_index_row(warn_if_not_found winf, const std::regex& re_serum_index)
+void ae::xlsx::v1::ExtractorCDC::find_serum_index_row(warn_if_not_found winf, const ae::regex::program_ref_t& re_serum_index)
 {
     fmt::memory_buffer report;
     for (nrow_t row{1}; row < antigen_rows()[0]; ++row) {
@@ -723,7 +870,7 @@ void ae::xlsx::v1::ExtractorCDC::find_serum_index_row(warn_if_not_found winf, co
 
 // ----------------------------------------------------------------------
 
-void ae::xlsx::v1::ExtractorCDC::find_serum_name_column(warn_if_not_found winf, const std::regex& re_serum_index)
+void ae::xlsx::v1::ExtractorCDC::find_serum_name_column(warn_if_not_found winf, const ae::regex::program_ref_t& re_serum_index)
 {
     for (ncol_t col{0}; col < ncol_t{5} && !serum_name_column_; ++col) {
         serum_rows_.clear();
@@ -759,20 +906,21 @@ void ae::xlsx::v1::ExtractorCDC::find_serum_name_column(warn_if_not_found winf,
 
 void ae::xlsx::v1::ExtractorCDC::find_serum_columns(warn_if_not_found /*winf*/)
 {
-    find_serum_column_label(re_CDC_lot_label, serum_id_column_, "LOT");
-    find_serum_column_label(re_CDC_species_label, serum_species_column_, "SPECIES");
-    find_serum_column_label(re_CDC_boosted_label, serum_boosted_column_, "BOOSTED");
-    find_serum_column_label(re_CDC_conc_label, serum_conc_column_, "CONC");
-    find_serum_column_label(re_CDC_dilut_label, serum_dilut_column_, "DILUT");
-    find_serum_column_label(re_CDC_passage_label, serum_passage_column_, "PASSAGE");
-    find_serum_column_label(re_CDC_pool_label, serum_pool_column_, "POOL");
+    // all labels in one scan of the row above the first serum row
+    const auto matches = sheet().grep(re_CDC_serum_labels, {serum_rows_[0] - nrow_t{1}, *serum_name_column_ + ncol_t{1}}, {serum_rows_[0], sheet().number_of_columns()});
+
+    find_serum_column_label(matches, cdc_lot, serum_id_column_, "LOT");
+    find_serum_column_label(matches, cdc_species, serum_species_column_, "SPECIES");
+    find_serum_column_label(matches, cdc_boosted, serum_boosted_column_, "BOOSTED");
+    find_serum_column_label(matches, cdc_conc, serum_conc_column_, "CONC");
+    find_serum_column_label(matches, cdc_dilut, serum_dilut_column_, "DILUT");
+    find_serum_column_label(matches, cdc_passage, serum_passage_column_, "PASSAGE");
+    find_serum_column_label(matches, cdc_pool, serum_pool_column_, "POOL");
 
-    if (const auto matches1 = sheet().grep(re_CDC_date_treated_label, {serum_rows_[0] - nrow_t{1}, *serum_name_column_ + ncol_t{1}}, {serum_rows_[0], sheet().number_of_columns()});
-        matches1.size() == 1) {
+    if (const auto matches1 = matches_of_pattern(matches, cdc_date_treated); matches1.size() == 1) {
         serum_treated_column_ = matches1[0].col;
     }
-    else if (const auto matches2 = sheet().grep(re_CDC_treated_label, {serum_rows_[0] - nrow_t{1}, *serum_name_column_ + ncol_t{1}}, {serum_rows_[0], sheet().number_of_columns()});
-             !matches2.empty()) {
+    else if (const auto matches2 = matches_of_pattern(matches, cdc_treated); !matches2.empty()) {
         for (const auto& mm2 : matches2) {
             if (sheet().matches(re_CDC_date_label, serum_rows_[0] - nrow_t{2}, mm2.col)) {
                 serum_treated_column_ = mm2.col;
@@ -785,26 +933,14 @@ void ae::xlsx::v1::ExtractorCDC::find_serum_columns(warn_if_not_found /*winf*/)
 
 // ----------------------------------------------------------------------
 
-void ae::xlsx::v1::ExtractorCDC::find_serum_column_label(const std::regex& re, std::optional<ncol_t>& col, std::string_view label_name)
+size_t ae::xlsx::v1::ExtractorCDC::find_serum_column_label(const std::vector<cell_match_t>& matches, size_t pattern_no, std::optional<ncol_t>& col, std::string_view label_name)
 {
-    if (const auto matches = sheet().grep(re, {serum_rows_[0] - nrow_t{1}, *serum_name_column_ + ncol_t{1}}, {serum_rows_[0], sheet().number_of_columns()}); matches.size() == 1)
-        col = matches[0].col;
-    else if (matches.size() > 1)
-        AD_WARNING("{} unclear {} label matches: {}", extractor_name(), label_name, matches);
-
-} // ae::xlsx::v1::ExtractorCDC::find_serum_column_label
-
-// ----------------------------------------------------------------------
-
-void ae::xlsx::v1::ExtractorCDC::find_serum_column_label(const std::regex& re1, const std::regex& re2, std::optional<ncol_t>& col, std::string_view label_name)
-{
-    const cell_addr_t min{serum_rows_[0] - nrow_t{2}, *serum_name_column_ + ncol_t{1}}, max{serum_rows_[0], sheet().number_of_columns()};
-    if (const auto matches = sheet().grepv(re1, re2, min, max); matches.size() == 1)
-        col = matches[0].col;
-    else if (matches.size() > 1)
-        AD_WARNING("{} unclear {} label matches: {}", extractor_name(), label_name, matches);
-    else
-        AD_WARNING("{} serum column {} not found in {}-{}", extractor_name(), label_name, min, max);
+    const auto found = matches_of_pattern(matches, pattern_no);
+    if (found.size() == 1)
+        col = found[0].col;
+    else if (found.size() > 1)
+        AD_WARNING("{} unclear {} label matches: {}", extractor_name(), label_name, found);
+    return found.size();
 
 } // ae::xlsx::v1::ExtractorCDC::find_serum_column_label
 
@@ -812,7 +948,7 @@ void ae::xlsx::v1::ExtractorCDC::find_serum_column_label(const std::regex& re1,
 
 bool ae::xlsx::v1::ExtractorCDC::valid_titer_row(nrow_t row, const column_range& /*cr*/) const
 {
-    return sheet().grep(re_CDC_serum_control, {row, ncol_t{0}}, {row + nrow_t{1}, sheet().number_of_columns()}).empty()
+    return !sheet().find_first(re_CDC_serum_control, {row, ncol_t{0}}, {row + nrow_t{1}, sheet().number_of_columns()}).has_value()
         && row > nrow_t{3};     // at least 4 rows must be above (sheet title, clade, passage, serum index)
 
 } // ae::xlsx::v1::ExtractorCDC::valid_titer_row
@@ -845,9 +981,9 @@ void ae::xlsx::v1::ExtractorCDC::exclude_control_sera(warn_if_not_found /*winf*/
 void ae::xlsx::v1::ExtractorCDC::adjust_titer_range(nrow_t row, column_range& cr)
 {
     if (cr.valid()) {
-        while (cr.second >= cr.first && !sheet().grep(re_CDC_titer_label, {nrow_t{0}, cr.second}, {row, cr.second + ncol_t{1}}).empty()) // ignore TITER and BACK TITER columns
+        while (cr.second >= cr.first && sheet().find_first(re_CDC_titer_label, {nrow_t{0}, cr.second}, {row, cr.second + ncol_t{1}}).has_value()) // ignore TITER and BACK TITER columns
             --cr.second;
-        if (cr.second >= cr.first && !sheet().grep(re_CDC_ha_group_label, {nrow_t{0}, cr.first}, {row, cr.first + ncol_t{1}}).empty()) // ignore HA GROUP looking like titer
+        if (cr.second >= cr.first && sheet().find_first(re_CDC_ha_group_label, {nrow_t{0}, cr.first}, {row, cr.first + ncol_t{1}}).has_value()) // ignore HA GROUP looking like titer
             ++cr.first;
     }
 
@@ -907,22 +1043,22 @@ ae::xlsx::v1::ExtractorAc21::ExtractorAc21(std::shared_ptr<Sheet> a_sheet)
 
 // ----------------------------------------------------------------------
 
-bool ae::xlsx::v1::ExtractorAc21::serum_index_matches(const cell_t& at_row, const cell_t& at_column) const
+std::string_view ae::xlsx::v1::ExtractorAc21::serum_index_key(const cell_ref_t& cell) const
 {
-    return !is_empty(at_row) && fmt::format("{}", at_row) == fmt::format("{}", at_column);
+    if (cell.is_empty())
+        return {};
+    return cell.text();
 
-} // ae::xlsx::v1::ExtractorAc21::serum_index_matches
+} // ae::xlsx::v1::ExtractorAc21::serum_index_key
 
 // ----------------------------------------------------------------------
 
 void ae::xlsx::v1::ExtractorAc21::find_antigen_lab_id_column(warn_if_not_found winf)
 {
-    if (const auto found = sheet().grep(re_AC21_ID_label, {nrow_t{5}, ncol_t{1}}, {antigen_rows_.front(), sheet().number_of_columns()}); !found.empty()) {
-        for (const auto& cell_match : found) {
-            if (fmt::format("{}", sheet().cell(cell_match.row - nrow_t{1}, cell_match.col)) == "Strain") {
-                antigen_lab_id_column_ = cell_match.col;
-                break;
-            }
+    for (const auto& cell_match : sheet().grep_lazy(re_AC21_ID_label, {nrow_t{5}, ncol_t{1}}, {antigen_rows_.front(), sheet().number_of_columns()})) {
+        if (sheet().text(cell_match.row - nrow_t{1}, cell_match.col) == "Strain") {
+            antigen_lab_id_column_ = cell_match.col;
+            break;
         }
     }
     if (!antigen_lab_id_column_)
@@ -937,6 +1073,7 @@ void ae::xlsx::v1::ExtractorAc21::find_serum_rows(warn_if_not_found winf)
     find_serum_index_row(winf, re_AC21_serum_index);
     find_serum_name_column(winf, re_AC21_serum_index);
     find_serum_columns(winf);
+    make_serum_index_rows();
 
 } // ae::xlsx::v1::ExtractorAc21::find_serum_rows
 
@@ -944,14 +1081,18 @@ void ae::xlsx::v1::ExtractorAc21::find_serum_rows(warn_if_not_found winf)
 
 void ae::xlsx::v1::ExtractorAc21::find_serum_columns(warn_if_not_found /*winf*/)
 {
-    find_serum_column_label(re_AC21_serum_label, re_AC21_ID_label, serum_id_column_, "SERUM-ID");
-    find_serum_column_label(re_AC21_serum_label, re_AC21_species_label, serum_species_column_, "SPECIES");
+    const cell_addr_t min{serum_rows_[0] - nrow_t{2}, *serum_name_column_ + ncol_t{1}}, max{serum_rows_[0], sheet().number_of_columns()};
+    const auto matches = sheet().grepv(re_AC21_serum_label, re_AC21_serum_labels, min, max);
+    if (find_serum_column_label(matches, ac21_id, serum_id_column_, "SERUM-ID") == 0)
+        AD_WARNING("{} serum column {} not found in {}-{}", extractor_name(), "SERUM-ID", min, max);
+    if (find_serum_column_label(matches, ac21_species, serum_species_column_, "SPECIES") == 0)
+        AD_WARNING("{} serum column {} not found in {}-{}", extractor_name(), "SPECIES", min, max);
 
 } // ae::xlsx::v1::ExtractorAc21::find_serum_columns
 
 // ----------------------------------------------------------------------
 
-ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorWithSerumRowsAbove::serum(size_t sr_no) const
+ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorWithSerumRowsAbove::make_serum(size_t sr_no) const
 {
     const auto make = [this, col = serum_columns().at(sr_no)](std::optional<nrow_t> row) -> std::string {
         if (row.has_value()) {
@@ -967,7 +1108,7 @@ ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorWithSerumRowsAbove::serum(si
         .passage = make_passage(make(serum_passage_row())) //
     };
 
-} // ae::xlsx::v1::ExtractorWithSerumRowsAbove::serum
+} // ae::xlsx::v1::ExtractorWithSerumRowsAbove::make_serum
 
 // ----------------------------------------------------------------------
 
@@ -998,6 +1139,7 @@ void ae::xlsx::v1::ExtractorWithSerumRowsAbove::force_serum_name_row(nrow_t row)
 {
     AD_INFO("forced serum name row: {}", row);
     serum_name_row_ = row;
+    make_sera();
 
 } // ae::xlsx::v1::ExtractorWithSerumRowsAbove::force_serum_name_row
 
@@ -1007,6 +1149,7 @@ void ae::xlsx::v1::ExtractorWithSerumRowsAbove::force_serum_passage_row(nrow_t r
 {
     AD_INFO("forced serum passage row: {}", row);
     serum_passage_row_ = row;
+    make_sera();
 
 } // ae::xlsx::v1::ExtractorWithSerumRowsAbove::force_serum_passage_row
 
@@ -1016,6 +1159,7 @@ void ae::xlsx::v1::ExtractorWithSerumRowsAbove::force_serum_id_row(nrow_t row)
 {
     AD_INFO("forced serum id row: {}", row);
     serum_id_row_ = row;
+    make_sera();
 
 } // ae::xlsx::v1::ExtractorWithSerumRowsAbove::force_serum_id_row
 
@@ -1115,11 +1259,11 @@ void ae::xlsx::v1::ExtractorCrick::find_serum_less_than_substitutions(warn_if_no
     if (!antigen_rows_.empty()) {
         if (const auto found = sheet().grep(re_CRICK_less_than, {antigen_rows_.back(), ncol_t{1}}, {sheet().number_of_rows(), ncol_t{2}}); !found.empty()) {
             for (const auto& cell_match : found)
-                footnote_index_subst_.emplace_back(ae::string::strip(fmt::format("{}", sheet().cell(cell_match.row, cell_match.col - ncol_t{1}))), cell_match.matches[1]);
+                footnote_index_subst_.emplace_back(ae::string::strip(sheet().text(cell_match.row, cell_match.col - ncol_t{1})), cell_match.matches[1]);
         }
-        else if (const auto found2 = sheet().grep(re_CRICK_less_than_multi, {antigen_rows_.back(), ncol_t{1}}, {sheet().number_of_rows(), ncol_t{2}}); !found2.empty()) {
-            // AD_DEBUG("[Crick]: less than subst (multi): {}", sheet().cell(found2[0].row, found2[0].col));
-            const auto cell = fmt::format("{}", sheet().cell(found2[0].row, found2[0].col)); // do not move inside split below, cannot survive within loop
+        else if (const auto found2 = sheet().find_first(re_CRICK_less_than_multi, {antigen_rows_.back(), ncol_t{1}}, {sheet().number_of_rows(), ncol_t{2}}); found2.has_value()) {
+            // AD_DEBUG("[Crick]: less than subst (multi): {}", sheet().cell(found2->row, found2->col));
+            const auto cell = sheet().text(found2->row, found2->col); // view into the sheet arena, valid while sheet is alive
             const auto split = [&cell]() {
                 if (cell.find(";") != std::string::npos)
                     return ae::string::split(cell, ";");
@@ -1128,7 +1272,7 @@ void ae::xlsx::v1::ExtractorCrick::find_serum_less_than_substitutions(warn_if_no
             };
 
             for (const auto& entry : split()) {
-                if (std::cmatch match; ae::regex::search(entry, match, re_CRICK_less_than_multi_entry))
+                if (ae::regex::match_t match; ae::regex::search(entry, match, re_CRICK_less_than_multi_entry))
                     footnote_index_subst_.emplace_back(match[1], match[2]);
             }
         }
@@ -1145,7 +1289,7 @@ void ae::xlsx::v1::ExtractorCrick::find_serum_less_than_substitutions(warn_if_no
             if (serum_id_row_.has_value()) {
                 for (const auto sr_no : range_from_0_to(number_of_sera())) {
                     const auto cell = sheet().cell(*serum_id_row_, serum_columns().at(sr_no));
-                    if (std::smatch match; sheet().matches(re_CRICK_serum_id, match, cell)) {
+                    if (ae::regex::match_t match; sheet().matches(re_CRICK_serum_id, match, cell)) {
                         serum_less_than_substitutions_[sr_no] = get_footnote(match.str(2), std::string{"<"});
                         AD_INFO("[Crick]:     SR: {} replacing \"<\" with \"{}\" (serum id footnote match: \"{}\")", sr_no, serum_less_than_substitutions_[sr_no], match.str(2));
                     }
@@ -1158,11 +1302,11 @@ void ae::xlsx::v1::ExtractorCrick::find_serum_less_than_substitutions(warn_if_no
 
 // ----------------------------------------------------------------------
 
-ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorCrick::serum(size_t sr_no) const
+ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorCrick::make_serum(size_t sr_no) const
 {
-    auto serum = ExtractorWithSerumRowsAbove::serum(sr_no);
+    auto serum = ExtractorWithSerumRowsAbove::make_serum(sr_no);
     if (serum_name_1_row_ && serum_name_2_row_) {
-        const auto n1{fmt::format("{}", sheet().cell(*serum_name_1_row_, serum_columns().at(sr_no)))}, n2{fmt::format("{}", sheet().cell(*serum_name_2_row_, serum_columns().at(sr_no)))};
+        const auto n1{sheet().text(*serum_name_1_row_, serum_columns().at(sr_no))}, n2{sheet().text(*serum_name_2_row_, serum_columns().at(sr_no))};
         if (n1.size() > 2 && n1[1] == '/')
             serum.name = fmt::format("{}/{}", n1, n2);
         else
@@ -1171,27 +1315,27 @@ ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorCrick::serum(size_t sr_no) c
     else
         serum.name = "*no serum_name_[12]_row_*";
 
-    if (std::smatch match; std::regex_match(serum.serum_id, match, re_CRICK_serum_id)) {
+    if (ae::regex::match_t match; ae::regex::match(serum.serum_id, match, re_CRICK_serum_id)) {
         // move to whocc-tables/*crick/whocc-xlsx-to-torg.py
         serum.serum_id = ae::string::uppercase(ae::string::replace(match.str(1), " ", "", ",", "/")); // remove spaces, replace , with /, e.g. "Sh  539, 540, 543, 544, 570, 571, 574" -> "SH539/540/543/544/570/571/574"
     }
 
     return serum;
 
-} // ae::xlsx::v1::ExtractorCrick::serum
+} // ae::xlsx::v1::ExtractorCrick::make_serum
 
 // ----------------------------------------------------------------------
 
-std::string ae::xlsx::v1::ExtractorCrick::titer(size_t ag_no, size_t sr_no) const
+void ae::xlsx::v1::ExtractorCrick::append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const
 {
-    auto result = ExtractorWithSerumRowsAbove::titer(ag_no, sr_no);
-    if ((result == "<" || result == ">") && sr_no < serum_less_than_substitutions_.size())
-        result = serum_less_than_substitutions_[sr_no];
-    else if (result == "ND")
-        result = "*";
-    return result;
+    const auto start = target.size();
+    ExtractorWithSerumRowsAbove::append_titer(target, sr_no, antigen_row);
+    if (const std::string_view titer{std::string_view{target}.substr(start)}; (titer == "<" || titer == ">") && sr_no < serum_less_than_substitutions_.size())
+        replace_titer(target, start, serum_less_than_substitutions_[sr_no]);
+    else if (titer == "ND")
+        replace_titer(target, start, "*");
 
-} // ae::xlsx::v1::ExtractorCrick::titer
+} // ae::xlsx::v1::ExtractorCrick::append_titer
 
 // ----------------------------------------------------------------------
 
@@ -1278,9 +1422,8 @@ std::string ae::xlsx::v1::ExtractorCrickPRN::titer_comment() const
 
 // ----------------------------------------------------------------------
 
-std::string ae::xlsx::v1::ExtractorCrickPRN::titer(size_t ag_no, size_t sr_no) const
+void ae::xlsx::v1::ExtractorCrickPRN::append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const
 {
-    using namespace std::string_view_literals;
     if (two_fold_read_row_.has_value()) {
         const auto left_col = serum_columns().at(sr_no);
         const auto two_fold_col = sheet().matches(re_CRICK_prn_2fold, *two_fold_read_row_, left_col) ? left_col : ncol_t{left_col + ncol_t{1}};
@@ -1290,27 +1433,14 @@ std::string ae::xlsx::v1::ExtractorCrickPRN::titer(size_t ag_no, size_t sr_no) c
         // clear, we just put < into togr and then converting it to
         // <10, <20, <40 when converting torg to ace
 
-        const auto extract = [](const auto& cell) {
-            return std::visit(
-                [&cell]<typename Content>(const Content& cont) {
-                    if constexpr (std::is_same_v<Content, std::string>)
-                        return cont;
-                    else if constexpr (std::is_same_v<Content, long>)
-                        return fmt::format("{}", cont);
-                    else if constexpr (std::is_same_v<Content, double>)
-                        return fmt::format("{}", std::lround(cont));
-                    else
-                        return fmt::format("{}", cell);
-                },
-                cell);
-        };
-
-        return fmt::format("{}/{}", extract(sheet().cell(antigen_rows().at(ag_no), two_fold_col)), extract(sheet().cell(antigen_rows().at(ag_no), read_col)));
+        append_titer_text(target, antigen_row.at(*two_fold_col), false);
+        target.push_back('/');
+        append_titer_text(target, antigen_row.at(*read_col), false);
     }
     else
-        return ExtractorCrick::titer(ag_no, sr_no);
+        ExtractorCrick::append_titer(target, sr_no, antigen_row);
 
-} // ae::xlsx::v1::ExtractorCrickPRN::titer
+} // ae::xlsx::v1::ExtractorCrickPRN::append_titer
 
 // ----------------------------------------------------------------------
 
@@ -1325,8 +1455,12 @@ ae::xlsx::v1::ExtractorNIID::ExtractorNIID(std::shared_ptr<Sheet> a_sheet)
 
 void ae::xlsx::v1::ExtractorNIID::find_antigen_lab_id_column(warn_if_not_found winf)
 {
-    if (const auto matches = sheet().grep(re_NIID_lab_id_label, {nrow_t{0}, ncol_t{0}}, {nrow_t{10}, ncol_t{2}}); matches.size() == 1) {
-        antigen_lab_id_column_ = matches[0].col;
+    // the label must be unique, scanning stops at the second one
+    const auto found = sheet().grep_lazy(re_NIID_lab_id_label, {nrow_t{0}, ncol_t{0}}, {nrow_t{10}, ncol_t{2}});
+    if (auto first = found.begin(); first != found.end()) {
+        const auto col = first->col;
+        if (++first == found.end())
+            antigen_lab_id_column_ = col;
     }
 
     if (antigen_lab_id_column_.has_value())
@@ -1339,20 +1473,20 @@ void ae::xlsx::v1::ExtractorNIID::find_antigen_lab_id_column(warn_if_not_found w
 
 // ----------------------------------------------------------------------
 
-ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorNIID::serum(size_t sr_no) const
+ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorNIID::make_serum(size_t sr_no) const
 {
     if (serum_name_row().has_value()) {
-        const auto serum_designation = fmt::format("{}", sheet().cell(*serum_name_row(), serum_columns().at(sr_no)));
-        if (std::smatch match; std::regex_search(serum_designation, match, re_NIID_serum_name)) {
+        const auto serum_designation = sheet().text(*serum_name_row(), serum_columns().at(sr_no));
+        if (ae::regex::match_t match; ae::regex::search(serum_designation, match, re_NIID_serum_name)) {
             auto name = ae::string::replace(ae::string::uppercase(match.str(1)), '\n', ' ');
-            name = std::regex_replace(name, re_NIID_serum_name_fix, "$1");
+            name = ae::regex::replace(name, re_NIID_serum_name_fix, "$1");
             if (name.size() > 2 && ((name[0] != 'A' && name[0] != 'B') || name[1] != '/'))
                 name = fmt::format("{}/{}", subtype_without_lineage(), name);
             // AD_DEBUG("serum fields \"{}\" \"{}\"", name, match.str(2));
             std::string passage;
-            if (std::smatch match_passage; std::regex_search(name, match_passage, re_NIID_serum_passage)) {
+            if (ae::regex::match_t match_passage; ae::regex::search(name, match_passage, re_NIID_serum_passage)) {
                 passage = ae::string::uppercase(match_passage.str(1));
-                name = match_passage.prefix();
+                name.resize(match_passage.position(0)); // prefix
             }
             // AD_DEBUG("serum fields2 \"{}\" \"{}\" \"{}\"", name, passage, match.str(2));
             return serum_fields_t{
@@ -1364,17 +1498,18 @@ ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorNIID::serum(size_t sr_no) co
     }
     return serum_fields_t{};
 
-} // ae::xlsx::v1::ExtractorNIID::serum
+} // ae::xlsx::v1::ExtractorNIID::make_serum
 
 // ----------------------------------------------------------------------
 
-std::string ae::xlsx::v1::ExtractorNIID::titer(size_t ag_no, size_t sr_no) const
+void ae::xlsx::v1::ExtractorNIID::append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const
 {
-    auto titer = ExtractorWithSerumRowsAbove::titer(ag_no, sr_no);
-    titer = ae::string::replace(titer, "\xEF\xBC\x9C", "<"); // unicode Fullwidth Less-Than Sign &#xFF1C
-    return titer;
+    const auto start = target.size();
+    ExtractorWithSerumRowsAbove::append_titer(target, sr_no, antigen_row);
+    if (const std::string_view titer{std::string_view{target}.substr(start)}; titer.find("\xEF\xBC\x9C") != std::string_view::npos)
+        replace_titer(target, start, ae::string::replace(titer, "\xEF\xBC\x9C", "<")); // unicode Fullwidth Less-Than Sign &#xFF1C
 
-} // ae::xlsx::v1::ExtractorNIID::titer
+} // ae::xlsx::v1::ExtractorNIID::append_titer
 
 // ----------------------------------------------------------------------
 
@@ -1393,7 +1528,7 @@ bool ae::xlsx::v1::ExtractorNIID::is_control_serum_cell(const cell_t& cell) cons
 
     if (is_string(cell)) {
         const auto text = fmt::format("{}", cell);
-        if (std::regex_search(text, re_NIID_serum_name_row_non_serum_label))
+        if (ae::regex::search(text, re_NIID_serum_name_row_non_serum_label))
             return true;
     }
     return false;
@@ -1421,7 +1556,7 @@ ae::xlsx::v1::ExtractorVIDRL::ExtractorVIDRL(std::shared_ptr<Sheet> a_sheet)
 
 std::string ae::xlsx::v1::ExtractorVIDRL::make_date(const std::string& src) const
 {
-    if (std::regex_search(src, re_VIDRL_antigen_date_column_title))
+    if (ae::regex::search(src, re_VIDRL_antigen_date_column_title))
         return {};              // column title in the antigen's row
     return ExtractorWithSerumRowsAbove::make_date(src);
 
@@ -1431,7 +1566,7 @@ std::string ae::xlsx::v1::ExtractorVIDRL::make_date(const std::string& src) cons
 
 std::string ae::xlsx::v1::ExtractorVIDRL::make_lab_id(const std::string& src) const
 {
-    if (std::regex_search(src, re_VIDRL_antigen_lab_id_column_title))
+    if (ae::regex::search(src, re_VIDRL_antigen_lab_id_column_title))
         return {};              // column title in the antigen's row
     return ExtractorWithSerumRowsAbove::make_lab_id(src);
 
@@ -1439,21 +1574,18 @@ std::string ae::xlsx::v1::ExtractorVIDRL::make_lab_id(const std::string& src) co
 
 // ----------------------------------------------------------------------
 
-ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorVIDRL::serum(size_t sr_no) const
+ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorVIDRL::make_serum(size_t sr_no) const
 {
-    auto serum = ExtractorWithSerumRowsAbove::serum(sr_no);
+    auto serum = ExtractorWithSerumRowsAbove::make_serum(sr_no);
     if (serum_name_row_) {
-        serum.name = fmt::format("{}", sheet().cell(*serum_name_row_, serum_columns().at(sr_no)));
+        serum.name = sheet().text(*serum_name_row_, serum_columns().at(sr_no));
 
         // TAS503 -> A(H3N2)/TASMANIA/503/2020
-        if (std::smatch match; std::regex_search(serum.name, match, re_VIDRL_serum_name)) {
-            for (const auto ag_no : range_from_0_to(number_of_antigens())) {
-                const auto antigen_name = antigen(ag_no).name;
-                const auto antigen_name_fields = ae::string::split(antigen_name, "/");
-                if (antigen_name_fields.size() == 4 && ae::string::startswith_ignore_case(antigen_name_fields[1], match.str(1)) && antigen_name_fields[2] == match.str(2)) {
-                    serum.name = antigen_name;
-                    break;
-                }
+        if (ae::regex::match_t match; ae::regex::search(serum.name, match, re_VIDRL_serum_name)) {
+            if (const auto found = antigen_names_.find(match.str(2)); found != antigen_names_.end()) {
+                if (const auto antigen = ranges::find_if(found->second, [location = match.str(1)](const auto& ag) { return ae::string::startswith_ignore_case(ag.location, location); });
+                    antigen != std::end(found->second))
+                    serum.name = antigen->name;
             }
         }
     }
@@ -1461,7 +1593,22 @@ ae::xlsx::v1::serum_fields_t ae::xlsx::v1::ExtractorVIDRL::serum(size_t sr_no) c
         serum.name = "*no serum_name_row_*";
     return serum;
 
-} // ae::xlsx::v1::ExtractorVIDRL::serum
+} // ae::xlsx::v1::ExtractorVIDRL::make_serum
+
+// ----------------------------------------------------------------------
+
+void ae::xlsx::v1::ExtractorVIDRL::make_lookup_tables()
+{
+    antigen_names_.clear();
+    for (const auto ag_no : range_from_0_to(number_of_antigens())) {
+        const auto antigen_name = antigen(ag_no).name;
+        if (const auto antigen_name_fields = ae::string::split(antigen_name, "/"); antigen_name_fields.size() == 4) {
+            auto& antigens = antigen_names_[std::string{antigen_name_fields[2]}];
+            antigens.push_back(antigen_name_t{.location = std::string{antigen_name_fields[1]}, .name = antigen_name});
+        }
+    }
+
+} // ae::xlsx::v1::ExtractorVIDRL::make_lookup_tables
 
 // ----------------------------------------------------------------------
 
@@ -1471,11 +1618,16 @@ void ae::xlsx::v1::ExtractorVIDRL::adjust_titer_range(nrow_t row, column_range&
         // VIDRL mutant table may have serum_id looking like a titer. If
         // the row has serum ids to the left or to the right of titer
         // range, invalidate the range
+        if (serum_ids_.empty()) {
+            // one scan of the sheet instead of two scans for every row
+            serum_ids_.resize(*sheet().number_of_rows(), bitset_t{*sheet().number_of_columns()});
+            for (const auto& found : sheet().grep(re_VIDRL_serum_id_with_days, sheet().min_cell(), sheet().max_cell()))
+                serum_ids_[*found.row].set(*found.col);
+        }
         // AD_DEBUG("vidrl adjust_titer_range {} {} {}", row, cr, sheet().grep(re_VIDRL_serum_id_with_days, {row, ncol_t{1}}, {row + nrow_t{1}, cr.first - ncol_t{1}}));
-        if (sheet().grep(re_VIDRL_serum_id_with_days, {row, ncol_t{1}}, {row + nrow_t{1}, cr.first - ncol_t{1}}).size() > 0 ||
-            sheet().grep(re_VIDRL_serum_id_with_days, {row, cr.second + ncol_t{1}}, {row + nrow_t{1}, sheet().number_of_columns()}).size() > 0) {
+        // left: columns [1, cr.first - 1), whole row from 1 if cr.first is 0, right: columns after cr.second
+        if (const auto& serum_ids = serum_ids_[*row]; serum_ids.next_set(1) < std::min(*cr.first - 1, serum_ids.size()) || serum_ids.next_set(*cr.second + 1) != bitset_t::npos)
             cr.first = ncol_t{max_row_col};
-        }
     }
 
 } // ae::xlsx::v1::ExtractorVIDRL::adjust_titer_range
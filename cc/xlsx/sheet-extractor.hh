@@ -1,10 +1,14 @@
 #pragma once
 
 #include <optional>
+#include <span>
+#include <unordered_map>
 // #include <vector>
 
 #include "ext/date.hh"
 #include "xlsx/sheet.hh"
+#include "xlsx/cell-index.hh"
+#include "xlsx/titer.hh"
 
 // ----------------------------------------------------------------------
 
@@ -34,6 +38,40 @@ namespace ae::xlsx::inline v1
         bool boosted{false};
     };
 
+    // titers of all antigens against all sera in antigen-major order, text of all of them in one buffer
+    class titer_matrix_t
+    {
+      public:
+        titer_matrix_t(size_t number_of_antigens = 0, size_t number_of_sera = 0) : number_of_sera_{number_of_sera}
+        {
+            offsets_.reserve(number_of_antigens * number_of_sera + 1);
+            text_.reserve(number_of_antigens * number_of_sera * 4);
+        }
+
+        size_t number_of_antigens() const { return number_of_sera_ == 0 ? 0 : (offsets_.size() - 1) / number_of_sera_; }
+        size_t number_of_sera() const { return number_of_sera_; }
+
+        std::string_view operator()(size_t ag_no, size_t sr_no) const
+        {
+            const auto cell_no = ag_no * number_of_sera_ + sr_no;
+            return std::string_view{text_}.substr(offsets_[cell_no], offsets_[cell_no + 1] - offsets_[cell_no]);
+        }
+
+        titer_t titer(size_t ag_no, size_t sr_no) const { return titer_t::parse(operator()(ag_no, sr_no)); }
+
+        // next titer in antigen-major order is appended by append(std::string&)
+        template <typename Append> void add(Append&& append)
+        {
+            append(text_);
+            offsets_.push_back(static_cast<uint32_t>(text_.size()));
+        }
+
+      private:
+        size_t number_of_sera_;
+        std::string text_{};
+        std::vector<uint32_t> offsets_{0}; // titer cell_no is text_[offsets_[cell_no], offsets_[cell_no + 1])
+    };
+
     struct detect_result_t
     {
         bool ignore{false};
@@ -68,11 +106,15 @@ namespace ae::xlsx::inline v1
         size_t number_of_antigens() const { return antigen_rows().size(); }
         size_t number_of_sera() const { return serum_columns().size(); }
 
-        virtual antigen_fields_t antigen(size_t ag_no) const;
-        virtual serum_fields_t serum(size_t sr_no) const = 0;
+        // fields made from the cells by preprocess, sera are remade by force_serum_*_row
+        const antigen_fields_t& antigen(size_t ag_no) const { return antigens_.at(ag_no); }
+        const serum_fields_t& serum(size_t sr_no) const { return sera_.at(sr_no); }
+        std::span<const antigen_fields_t> antigens() const { return antigens_; }
+        std::span<const serum_fields_t> sera() const { return sera_; }
 
         virtual std::string titer_comment() const { return {}; }
-        virtual std::string titer(size_t ag_no, size_t sr_no) const;
+        std::string titer(size_t ag_no, size_t sr_no) const;
+        titer_matrix_t titers() const; // all titers in one pass over the antigen rows
 
         void lab(std::string_view a_lab) { lab_ = a_lab; }
         void subtype(std::string_view a_subtype) { subtype_ = a_subtype; }
@@ -101,9 +143,15 @@ namespace ae::xlsx::inline v1
         virtual void find_antigen_passage_column(warn_if_not_found winf);
         virtual void find_antigen_lab_id_column(warn_if_not_found winf);
         virtual void find_serum_rows(warn_if_not_found) {}
-        virtual std::optional<nrow_t> find_serum_row(const std::regex& re, std::string_view row_name, warn_if_not_found winf, std::optional<nrow_t> ignore = std::nullopt) const;
+        virtual std::optional<nrow_t> find_serum_row(const ae::regex::program_ref_t& re, std::string_view row_name, warn_if_not_found winf, std::optional<nrow_t> ignore = std::nullopt) const;
         virtual void exclude_control_sera(warn_if_not_found winf) = 0;
         virtual void adjust_titer_range(nrow_t /*row*/, column_range& /*cr*/) {}
+        virtual void make_lookup_tables() {} // for make_serum, by preprocess when rows, columns and antigens are known
+        virtual antigen_fields_t make_antigen(size_t ag_no) const;
+        virtual serum_fields_t make_serum(size_t sr_no) const = 0;
+        // appends titer of the serum in the antigen row to target, lab specific substitutions applied
+        virtual void append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const;
+        void make_sera();
 
         std::optional<ncol_t> antigen_name_column() const { return antigen_name_column_; }
         std::optional<ncol_t> antigen_date_column() const { return antigen_date_column_; }
@@ -132,6 +180,8 @@ namespace ae::xlsx::inline v1
 
       private:
         std::shared_ptr<Sheet> sheet_;
+        std::vector<antigen_fields_t> antigens_{};
+        std::vector<serum_fields_t> sera_{};
         std::string lab_{};
         std::string subtype_{};
         std::string lineage_{};
@@ -143,6 +193,16 @@ namespace ae::xlsx::inline v1
 
     std::shared_ptr<Extractor> extractor_factory(std::shared_ptr<Sheet> sheet, const detect_result_t& detected, Extractor::warn_if_not_found winf);
 
+    // patterns used by the extractors, to benchmark regex backends against real cells
+    struct extractor_pattern_t
+    {
+        std::string_view name;
+        std::string_view pattern;
+        ae::regex::program_ref_t program;
+    };
+
+    std::vector<extractor_pattern_t> extractor_patterns();
+
     // ----------------------------------------------------------------------
 
     class ExtractorCDC : public Extractor
@@ -150,21 +210,20 @@ namespace ae::xlsx::inline v1
       public:
         ExtractorCDC(std::shared_ptr<Sheet> a_sheet);
 
-        serum_fields_t serum(size_t sr_no) const override;
-        std::string titer(size_t ag_no, size_t sr_no) const override;
-
         void check_export_possibility() const override; // throws Error if exporting is not possible
 
         const char* extractor_name() const override { return "[CDC]"; }
 
       protected:
+        void append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const override;
+        serum_fields_t make_serum(size_t sr_no) const override;
         bool is_lab_id(const cell_t& cell) const override;
         void find_serum_rows(warn_if_not_found winf) override;
         virtual void find_serum_columns(warn_if_not_found winf);
-        virtual void find_serum_name_column(warn_if_not_found winf, const std::regex& re_serum_index);
-        void find_serum_column_label(const std::regex& re, std::optional<ncol_t>& col, std::string_view label_name);
-        void find_serum_column_label(const std::regex& re1, const std::regex& re2, std::optional<ncol_t>& col, std::string_view label_name);
-        void find_serum_index_row(warn_if_not_found winf, const std::regex& re_serum_index);
+        virtual void find_serum_name_column(warn_if_not_found winf, const ae::regex::program_ref_t& re_serum_index);
+        // sets col if exactly one of matches is for pattern_no (of a regex set), returns number of such matches
+        size_t find_serum_column_label(const std::vector<cell_match_t>& matches, size_t pattern_no, std::optional<ncol_t>& col, std::string_view label_name);
+        void find_serum_index_row(warn_if_not_found winf, const ae::regex::program_ref_t& re_serum_index);
         void remove_redundant_antigen_rows(warn_if_not_found winf) override;
         void exclude_control_sera(warn_if_not_found winf) override;
         void adjust_titer_range(nrow_t row, column_range& cr) override;
@@ -173,12 +232,15 @@ namespace ae::xlsx::inline v1
 
         std::string report_serum_anchors() const override;
 
-        virtual bool serum_index_matches(const cell_t& at_row, const cell_t& at_column) const;
+        // serum index in the serum index row and in the serum index column match if their keys are equal, empty key never matches
+        virtual std::string_view serum_index_key(const cell_ref_t& cell) const;
 
         std::optional<nrow_t> serum_index_row_;
         std::vector<nrow_t> serum_rows_;
         std::optional<ncol_t> serum_index_column_, serum_name_column_, serum_id_column_, serum_treated_column_, serum_species_column_, serum_boosted_column_, serum_conc_column_, serum_dilut_column_, serum_passage_column_, serum_pool_column_;
+        std::unordered_map<std::string, nrow_t> serum_index_rows_; // serum index key -> first row having it in the serum index column, from serum_rows_[0] down
 
+        void make_serum_index_rows(); // called by find_serum_rows
         nrow_t find_serum_row_by_col(ncol_t col) const;
     };
 
@@ -190,7 +252,7 @@ namespace ae::xlsx::inline v1
         ExtractorAc21(std::shared_ptr<Sheet> a_sheet);
 
         const char* extractor_name() const override { return "[AC21]"; }
-        bool serum_index_matches(const cell_t& at_row, const cell_t& at_column) const override;
+        std::string_view serum_index_key(const cell_ref_t& cell) const override;
 
       protected:
         // bool is_lab_id(const cell_t& cell) const override;
@@ -206,8 +268,6 @@ namespace ae::xlsx::inline v1
     public:
         using Extractor::Extractor;
 
-        serum_fields_t serum(size_t sr_no) const override;
-
         void check_export_possibility() const override; // throws Error if exporting is not possible
 
         void force_serum_name_row(nrow_t row) override;
@@ -215,8 +275,9 @@ namespace ae::xlsx::inline v1
         void force_serum_id_row(nrow_t row) override;
 
       protected:
-        virtual void find_serum_passage_row(const std::regex& re, warn_if_not_found winf) { serum_passage_row_ = find_serum_row(re, "passage", winf); }
-        virtual void find_serum_id_row(const std::regex& re, warn_if_not_found winf) { serum_id_row_ = find_serum_row(re, "id", winf); }
+        serum_fields_t make_serum(size_t sr_no) const override;
+        virtual void find_serum_passage_row(const ae::regex::program_ref_t& re, warn_if_not_found winf) { serum_passage_row_ = find_serum_row(re, "passage", winf); }
+        virtual void find_serum_id_row(const ae::regex::program_ref_t& re, warn_if_not_found winf) { serum_id_row_ = find_serum_row(re, "id", winf); }
         void exclude_control_sera(warn_if_not_found winf) override;
 
         std::optional<nrow_t> serum_name_row() const { return serum_name_row_; }
@@ -235,14 +296,13 @@ namespace ae::xlsx::inline v1
       public:
         ExtractorCrick(std::shared_ptr<Sheet> a_sheet);
 
-        serum_fields_t serum(size_t sr_no) const override;
-        std::string titer(size_t ag_no, size_t sr_no) const override;
-
         void check_export_possibility() const override; // throws Error if exporting is not possible
 
         const char* extractor_name() const override { return "[Crick]"; }
 
       protected:
+        void append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const override;
+        serum_fields_t make_serum(size_t sr_no) const override;
         void find_serum_rows(warn_if_not_found winf) override;
         void find_serum_name_rows(warn_if_not_found winf);
         void find_serum_less_than_substitutions(warn_if_not_found winf);
@@ -261,11 +321,11 @@ namespace ae::xlsx::inline v1
         ExtractorCrickPRN(std::shared_ptr<Sheet> a_sheet);
 
         std::string titer_comment() const override;
-        std::string titer(size_t ag_no, size_t sr_no) const override;
 
         const char* extractor_name() const override { return "[CrickPRN]"; }
 
       protected:
+        void append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const override;
         void find_serum_rows(warn_if_not_found winf) override;
 
       private:
@@ -281,12 +341,11 @@ namespace ae::xlsx::inline v1
       public:
         ExtractorNIID(std::shared_ptr<Sheet> a_sheet);
 
-        serum_fields_t serum(size_t sr_no) const override;
-        std::string titer(size_t ag_no, size_t sr_no) const override;
-
         const char* extractor_name() const override { return "[NIID]"; }
 
       protected:
+        void append_titer(std::string& target, size_t sr_no, const cell_view_t& antigen_row) const override;
+        serum_fields_t make_serum(size_t sr_no) const override;
         void find_antigen_lab_id_column(warn_if_not_found winf) override;
         void find_serum_rows(warn_if_not_found winf) override;
         bool is_control_serum_cell(const cell_t& cell) const override;
@@ -301,16 +360,26 @@ namespace ae::xlsx::inline v1
       public:
         ExtractorVIDRL(std::shared_ptr<Sheet> a_sheet);
 
-        serum_fields_t serum(size_t sr_no) const override;
-
         const char* extractor_name() const override { return "[VIDRL]"; }
 
       protected:
+        serum_fields_t make_serum(size_t sr_no) const override;
         bool is_lab_id(const cell_t& cell) const override;
         void find_serum_rows(warn_if_not_found winf) override;
         std::string make_date(const std::string& src) const override;
         std::string make_lab_id(const std::string& src) const override;
         void adjust_titer_range(nrow_t row, column_range& cr) override;
+        void make_lookup_tables() override;
+
+      private:
+        struct antigen_name_t
+        {
+            std::string location; // second field of the name
+            std::string name;
+        };
+
+        std::vector<bitset_t> serum_ids_{}; // [row] -> bit per column of cells with serum id with days, filled on the first adjust_titer_range call
+        std::unordered_map<std::string, std::vector<antigen_name_t>> antigen_names_{}; // isolate number -> antigens with 4-field names in antigen order, serum names refer to them
     };
 
 } // namespace ae::xlsx::inline v1
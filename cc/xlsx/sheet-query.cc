@@ -0,0 +1,113 @@
+#include <numeric>
+
+#include "xlsx/sheet-query.hh"
+#include "xlsx/sheet-scan.hh"
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::v1::sheet_query_t& ae::xlsx::v1::sheet_query_t::at(ssize_t rows, ssize_t cols, predicate_t predicate, capture cap)
+{
+    // bitset lookup, string comparison, regex with a literal to prefilter, other regex, arbitrary function
+    const auto cost = std::visit(
+        []<typename Pred>(const Pred& pred) -> size_t {
+            if constexpr (std::is_same_v<Pred, cell_kind>)
+                return 1;
+            else if constexpr (std::is_same_v<Pred, text_t>)
+                return 2;
+            else if constexpr (std::is_same_v<Pred, ae::regex::program_ref_t>)
+                return pred.prefilter.literal_size > 0 ? 3 : 4;
+            else if constexpr (std::is_same_v<Pred, ae::regex::regex_t>)
+                return 4;
+            else
+                return 5;
+        },
+        predicate);
+    terms_.push_back(term_t{.rows = rows, .cols = cols, .predicate = std::move(predicate), .cap = cap, .cost = cost});
+
+    order_.resize(terms_.size());
+    std::iota(std::begin(order_), std::end(order_), size_t{0});
+    std::stable_sort(std::begin(order_), std::end(order_), [this](size_t t1, size_t t2) { return terms_[t1].cost < terms_[t2].cost; });
+    return *this;
+
+} // ae::xlsx::v1::sheet_query_t::at
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::v1::sheet_query_t::binding_t> ae::xlsx::v1::sheet_query_t::find_all(const Sheet& sheet, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    if (terms_.empty())
+        return {};
+    const auto last_col = std::min(max.col, sheet.number_of_columns());
+    return scan_rows<binding_t>(sheet, min, max, [this, &sheet, &min, last_col](std::vector<binding_t>& result, nrow_t row) { find_in_row(sheet, row, min.col, last_col, result); });
+
+} // ae::xlsx::v1::sheet_query_t::find_all
+
+// ----------------------------------------------------------------------
+
+void ae::xlsx::v1::sheet_query_t::find_in_row(const Sheet& sheet, nrow_t row, ncol_t first_col, ncol_t last_col, std::vector<binding_t>& result) const
+{
+    const auto driver_no = order_.front();
+    const auto& driver = terms_[driver_no];
+    std::vector<cell_match_view_t> cells(terms_.size());
+
+    // driver term held at the anchor col, probe the others
+    const auto bind = [&](ncol_t col) {
+        for (auto term_no = std::next(std::begin(order_)); term_no != std::end(order_); ++term_no) {
+            if (!test(terms_[*term_no], sheet, row, col, cells[*term_no]))
+                return;
+        }
+        result.push_back(binding_t{.row = row, .col = col, .cells = cells});
+    };
+
+    if (const auto* kind = std::get_if<cell_kind>(&driver.predicate); kind != nullptr) {
+        // candidates are the set bits of the driver row in the type index, cells are not touched
+        const auto driver_row = static_cast<ssize_t>(*row) + driver.rows;
+        if (driver_row < 0 || driver_row >= static_cast<ssize_t>(*sheet.number_of_rows()))
+            return;
+        const auto& bits = sheet.type_index().row(nrow_t{driver_row}, *kind);
+        const auto first_bit = static_cast<ssize_t>(*first_col) + driver.cols;
+        for (auto bit = bits.next_set(static_cast<size_t>(std::max(first_bit, ssize_t{0}))); bit != bitset_t::npos; bit = bits.next_set(bit + 1)) {
+            const auto col = static_cast<ssize_t>(bit) - driver.cols;
+            if (col >= static_cast<ssize_t>(*last_col))
+                break;
+            cells[driver_no] = cell_match_view_t{.row = nrow_t{driver_row}, .col = ncol_t{bit}};
+            bind(ncol_t{col});
+        }
+    }
+    else {
+        for (auto col = first_col; col < last_col; ++col) {
+            if (test(driver, sheet, row, col, cells[driver_no]))
+                bind(col);
+        }
+    }
+
+} // ae::xlsx::v1::sheet_query_t::find_in_row
+
+// ----------------------------------------------------------------------
+
+bool ae::xlsx::v1::sheet_query_t::test(const term_t& term, const Sheet& sheet, nrow_t row, ncol_t col, cell_match_view_t& found) const
+{
+    const auto term_row = static_cast<ssize_t>(*row) + term.rows, term_col = static_cast<ssize_t>(*col) + term.cols;
+    if (term_row < 0 || term_col < 0 || term_row >= static_cast<ssize_t>(*sheet.number_of_rows()) || term_col >= static_cast<ssize_t>(*sheet.number_of_columns()))
+        return false;
+
+    found = cell_match_view_t{.row = nrow_t{term_row}, .col = ncol_t{term_col}};
+    const auto cell = sheet.row(found.row).at(static_cast<size_t>(term_col));
+    return std::visit(
+        [&]<typename Pred>(const Pred& pred) -> bool {
+            if constexpr (std::is_same_v<Pred, cell_kind>)
+                return sheet.type_index().is(found.row, found.col, pred);
+            else if constexpr (std::is_same_v<Pred, text_t>)
+                return cell.text() == pred.text;
+            else if constexpr (std::is_same_v<Pred, function_t>)
+                return pred(cell);
+            else if (term.cap == capture::yes)
+                return Sheet::matches(pred, found.match, cell);
+            else
+                return Sheet::matches(pred, cell);
+        },
+        term.predicate);
+
+} // ae::xlsx::v1::sheet_query_t::test
+
+// ----------------------------------------------------------------------
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <functional>
+#include <variant>
+
+#include "xlsx/sheet.hh"
+#include "xlsx/cell-index.hh"
+
+// ----------------------------------------------------------------------
+// Multi-cell patterns: cells at fixed offsets from an anchor cell, a
+// predicate for each of them, declared once and found in one sweep.
+//
+//   const auto query = sheet_query_t{}
+//       .at(0, 0, re_AC21_ID_label, sheet_query_t::capture::yes)  // label
+//       .at(-1, 0, sheet_query_t::text_t{"Strain"})             // header above
+//       .at(1, 0, cell_kind::string);                           // value below
+//   for (const auto& found : query.find_all(sheet, min, max))
+//       found.row, found.col (anchor), found.cells[0][0] (groups of the first term)
+//
+// Terms are evaluated cheapest first: the cheapest one at every anchor
+// position of the region (cell kind terms read the type index bitsets
+// without touching cells), the others only where the cheaper ones held.
+// Anchor positions are in the region, term cells may be outside it but
+// not outside the sheet.
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    class sheet_query_t
+    {
+      public:
+        // regex with captures: groups are reported, only string cells match (like grep),
+        // otherwise the text of any cell is matched (like Sheet::matches)
+        enum class capture { no, yes };
+
+        struct text_t // whole cell text equals
+        {
+            std::string text;
+        };
+
+        using function_t = std::function<bool(const cell_ref_t&)>;
+        using predicate_t = std::variant<cell_kind, text_t, ae::regex::program_ref_t, ae::regex::regex_t, function_t>;
+
+        // anchor bound to the query at one position, cells are in the order of at() calls
+        struct binding_t
+        {
+            nrow_t row;
+            ncol_t col;
+            std::vector<cell_match_view_t> cells;
+        };
+
+        // rows and cols are relative to the anchor, the anchor itself is at(0, 0, ...)
+        sheet_query_t& at(ssize_t rows, ssize_t cols, predicate_t predicate, capture cap = capture::no);
+
+        // bindings in row-major order of the anchor, large regions are scanned in parallel (see sheet-scan.hh)
+        std::vector<binding_t> find_all(const Sheet& sheet, const cell_addr_t& min, const cell_addr_t& max) const;
+
+      private:
+        struct term_t
+        {
+            ssize_t rows;
+            ssize_t cols;
+            predicate_t predicate;
+            capture cap;
+            size_t cost; // relative, see at()
+        };
+
+        std::vector<term_t> terms_{};
+        std::vector<size_t> order_{}; // term indexes, cheapest first
+
+        void find_in_row(const Sheet& sheet, nrow_t row, ncol_t first_col, ncol_t last_col, std::vector<binding_t>& result) const;
+        bool test(const term_t& term, const Sheet& sheet, nrow_t row, ncol_t col, cell_match_view_t& found) const;
+    };
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
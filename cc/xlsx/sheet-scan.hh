@@ -0,0 +1,56 @@
+#pragma once
+
+#include <numeric>
+
+#include "utils/thread-pool.hh"
+#include "xlsx/sheet.hh"
+
+// ----------------------------------------------------------------------
+// Row by row scan of a sheet region shared by grep, grepv and sheet_query_t
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    // regions with fewer cells are scanned by the calling thread only
+    inline constexpr const size_t parallel_scan_min_cells{16384};
+    // cells per block of rows scanned by one thread
+    inline constexpr const size_t scan_block_cells{4096};
+
+    // scan_row(result, row) for each row of the region, blocks of rows are
+    // scanned in parallel, results are concatenated in row order, i.e.
+    // the same as of the serial scan
+    template <typename Result, typename ScanRow> std::vector<Result> scan_rows(const Sheet& sheet, const cell_addr_t& min, const cell_addr_t& max, ScanRow scan_row)
+    {
+        const auto last_row = std::min(max.row, sheet.number_of_rows());
+        if (min.row >= last_row)
+            return {};
+        const auto last_col = std::min(max.col, sheet.number_of_columns());
+        const size_t rows = *last_row - *min.row;
+        const size_t cols = min.col < last_col ? *last_col - *min.col : 0;
+
+        if ((rows * cols) < parallel_scan_min_cells) {
+            std::vector<Result> result;
+            for (auto row = min.row; row < last_row; ++row)
+                scan_row(result, row);
+            return result;
+        }
+
+        const size_t rows_per_block = std::max(scan_block_cells / std::max(cols, size_t{1}), size_t{1});
+        std::vector<std::vector<Result>> block_results((rows + rows_per_block - 1) / rows_per_block);
+        ae::parallel::for_each_block(block_results.size(), [&](size_t block_no) {
+            const nrow_t first{*min.row + block_no * rows_per_block};
+            const nrow_t last{std::min(*first + rows_per_block, *last_row)};
+            for (auto row = first; row < last; ++row)
+                scan_row(block_results[block_no], row);
+        });
+
+        std::vector<Result> result;
+        result.reserve(std::accumulate(std::begin(block_results), std::end(block_results), size_t{0}, [](size_t sum, const auto& block) { return sum + block.size(); }));
+        for (auto& block : block_results)
+            std::move(std::begin(block), std::end(block), std::back_inserter(result));
+        return result;
+    }
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
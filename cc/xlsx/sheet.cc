@@ -1,17 +1,21 @@
 #include "ext/range-v3.hh"
 #include "xlsx/sheet.hh"
+#include "xlsx/cell-index.hh"
+#include "xlsx/titer.hh"
+#include "xlsx/sheet-scan.hh"
+#include "xlsx/sheet-query.hh"
 #include "utils/log.hh"
 
 // ----------------------------------------------------------------------
 
-bool ae::xlsx::v1::Sheet::matches(const std::regex& re, const cell_t& cell)
+bool ae::xlsx::v1::Sheet::matches(const ae::regex::regex_t& re, const cell_t& cell)
 {
     return std::visit(
         [&re, &cell]<typename Content>(const Content& arg) {
             if constexpr (std::is_same_v<Content, std::string>)
-                return std::regex_search(arg, re);
+                return ae::regex::search(arg, re);
             else
-                return std::regex_search(fmt::format("{}", cell), re); // CDC id is a number in CDC tables, still we want to match
+                return ae::regex::search(fmt::format("{}", cell), re); // CDC id is a number in CDC tables, still we want to match
         },
         cell);
 
@@ -19,12 +23,12 @@ bool ae::xlsx::v1::Sheet::matches(const std::regex& re, const cell_t& cell)
 
 // ----------------------------------------------------------------------
 
-bool ae::xlsx::v1::Sheet::matches(const std::regex& re, std::smatch& match, const cell_t& cell)
+bool ae::xlsx::v1::Sheet::matches(const ae::regex::regex_t& re, ae::regex::match_t& match, const cell_t& cell)
 {
     return std::visit(
         [&re, &match]<typename Content>(const Content& arg) {
             if constexpr (std::is_same_v<Content, std::string>)
-                return std::regex_search(arg, match, re);
+                return ae::regex::search(arg, match, re);
             else
                 return false;
         },
@@ -34,6 +38,74 @@ bool ae::xlsx::v1::Sheet::matches(const std::regex& re, std::smatch& match, cons
 
 // ----------------------------------------------------------------------
 
+bool ae::xlsx::v1::Sheet::matches(const ae::regex::regex_t& re, const cell_ref_t& cell)
+{
+    return ae::regex::search_folded(cell.folded(), cell.text(), re); // numbers are matched by their text (CDC id is a number in CDC tables)
+
+} // ae::xlsx::v1::Sheet::matches
+
+// ----------------------------------------------------------------------
+
+bool ae::xlsx::v1::Sheet::matches(const ae::regex::regex_t& re, ae::regex::match_t& match, const cell_ref_t& cell)
+{
+    if (cell.is_string())
+        return ae::regex::search_folded(cell.folded(), cell.str(), match, re);
+    else
+        return false;
+
+} // ae::xlsx::v1::Sheet::matches
+
+// ----------------------------------------------------------------------
+
+bool ae::xlsx::v1::Sheet::matches(const ae::regex::program_ref_t& re, const cell_t& cell)
+{
+    return std::visit(
+        [&re, &cell]<typename Content>(const Content& arg) {
+            if constexpr (std::is_same_v<Content, std::string>)
+                return ae::regex::search(arg, re);
+            else
+                return ae::regex::search(fmt::format("{}", cell), re); // CDC id is a number in CDC tables, still we want to match
+        },
+        cell);
+
+} // ae::xlsx::v1::Sheet::matches
+
+// ----------------------------------------------------------------------
+
+bool ae::xlsx::v1::Sheet::matches(const ae::regex::program_ref_t& re, ae::regex::match_t& match, const cell_t& cell)
+{
+    return std::visit(
+        [&re, &match]<typename Content>(const Content& arg) {
+            if constexpr (std::is_same_v<Content, std::string>)
+                return ae::regex::search(arg, match, re);
+            else
+                return false;
+        },
+        cell);
+
+} // ae::xlsx::v1::Sheet::matches
+
+// ----------------------------------------------------------------------
+
+bool ae::xlsx::v1::Sheet::matches(const ae::regex::program_ref_t& re, const cell_ref_t& cell)
+{
+    return ae::regex::search_folded(cell.folded(), cell.text(), re); // numbers are matched by their text (CDC id is a number in CDC tables)
+
+} // ae::xlsx::v1::Sheet::matches
+
+// ----------------------------------------------------------------------
+
+bool ae::xlsx::v1::Sheet::matches(const ae::regex::program_ref_t& re, ae::regex::match_t& match, const cell_ref_t& cell)
+{
+    if (cell.is_string())
+        return ae::regex::search_folded(cell.folded(), cell.str(), match, re);
+    else
+        return false;
+
+} // ae::xlsx::v1::Sheet::matches
+
+// ----------------------------------------------------------------------
+
 size_t ae::xlsx::v1::Sheet::size(const cell_t& cell) const
 {
     return std::visit(
@@ -49,18 +121,6 @@ size_t ae::xlsx::v1::Sheet::size(const cell_t& cell) const
 
 // ----------------------------------------------------------------------
 
-#pragma GCC diagnostic push
-#ifdef __clang__
-#pragma GCC diagnostic ignored "-Wglobal-constructors"
-#pragma GCC diagnostic ignored "-Wexit-time-destructors"
-#endif
-
-// "\xEF\xBC\x9C" -> "<" unicode Fullwidth Less-Than Sign &#xFF1C; (NIID)
-// ">" and "," - perhaps typos in Crick tables
-static const std::regex re_titer{R"(^\s*(<|>|,|(?:<|>|\xEF\xBC\x9C)?\s*[1-9][0-9]{0,5}|N[DAT]|QNS|\*)\s*$)", std::regex::icase | std::regex::ECMAScript | std::regex::optimize};
-
-#pragma GCC diagnostic pop
-
 bool ae::xlsx::v1::Sheet::maybe_titer(const cell_t& cell) const
 {
     return std::visit(
@@ -71,7 +131,7 @@ bool ae::xlsx::v1::Sheet::maybe_titer(const cell_t& cell) const
                 //     for (auto cc : arg)
                 //         AD_DEBUG("titer? 0x{:X}", static_cast<unsigned char>(cc));
                 // }
-                return std::regex_search(arg, re_titer);
+                return is_titer(arg); // see xlsx/titer.hh for the accepted language
             }
             else if constexpr (std::is_same_v<Content, double> || std::is_same_v<Content, long>)
                 return arg > 0;
@@ -84,77 +144,253 @@ bool ae::xlsx::v1::Sheet::maybe_titer(const cell_t& cell) const
 
 // ----------------------------------------------------------------------
 
-ae::xlsx::v1::column_range ae::xlsx::v1::Sheet::titer_range(nrow_t row) const
+bool ae::xlsx::v1::Sheet::maybe_titer(const cell_ref_t& cell) const
 {
-    range<ncol_t> longest;
-    range<ncol_t> current;
-    const auto update = [&longest, &current] {
-        if (current.valid()) {
-            if (!longest.valid() || longest.length() < current.length()) {
-                longest = current;
-                // AD_DEBUG("longest {}: {}", row, longest);
-            }
-            current = range<ncol_t>{};
-        }
-    };
-
-    for (auto col = ncol_t{0}; col < number_of_columns(); ++col) {
-        // AD_DEBUG("maybe_titer {}:{} \"{}\"", row, col, cell(row, col));
-        if (maybe_titer(row, col)) {
-            if (!current.valid())
-                current.first = col;
-            current.second = col;
-            // AD_DEBUG("titer {}{}: {} --> {}", row, col, cell(row, col), current);
-        }
-        else
-            update();
+    switch (cell.type()) {
+        case cell_type::string:
+            return is_titer(cell.str());
+        case cell_type::real:
+            return cell.compact().real() > 0;
+        case cell_type::integer:
+            return cell.compact().integer() > 0;
+        case cell_type::empty:
+        case cell_type::error:
+        case cell_type::boolean:
+        case cell_type::date:
+            break;
     }
-    update();
-    return longest;
+    return false;
+
+} // ae::xlsx::v1::Sheet::maybe_titer
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::v1::column_range ae::xlsx::v1::Sheet::titer_range(nrow_t row) const
+{
+    return type_index().titer_range(row);
 
 } // ae::xlsx::v1::Sheet::titer_range
 
 // ----------------------------------------------------------------------
 
-std::vector<ae::xlsx::cell_match_t> ae::xlsx::v1::Sheet::grep(const std::regex& rex, const cell_addr_t& min, const cell_addr_t& max) const
+const ae::xlsx::v1::cell_type_index_t& ae::xlsx::v1::Sheet::type_index() const
+{
+    std::call_once(type_index_built_, [this] { type_index_ = std::make_shared<const cell_type_index_t>(*this); });
+    return *type_index_;
+
+} // ae::xlsx::v1::Sheet::type_index
+
+// ----------------------------------------------------------------------
+
+const ae::xlsx::v1::cell_token_index_t& ae::xlsx::v1::Sheet::token_index() const
+{
+    std::call_once(token_index_once_, [this] {
+        token_index_ = std::make_shared<const cell_token_index_t>(*this);
+        token_index_built_.store(true, std::memory_order_release);
+    });
+    return *token_index_;
+
+} // ae::xlsx::v1::Sheet::token_index
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
 {
-    std::vector<cell_match_t> result;
-    for (auto row = min.row; row < max.row; ++row) {
-        for (auto col = min.col; col < max.col; ++col) {
-            const auto cl = cell(row, col);
-            // AD_DEBUG("xlsx::grep {} {} \"{}\"", row, col, cl);
-            std::smatch match;
-            if (matches(rex, match, cl)) {
-                cell_match_t cm{.row = row, .col = col, .matches = std::vector<std::string>(match.size())};
-                std::transform(std::cbegin(match), std::cend(match), std::begin(cm.matches), [](const auto& submatch) { return submatch.str(); });
-                result.push_back(std::move(cm));
+    // the token index may narrow a grep only by the literal of an exactly parsed program:
+    // compile time patterns and run time patterns dynamic_regex accepted (regex_t has no
+    // prefilter otherwise), a literal guessed from unsupported syntax could drop matches
+    inline const ae::regex::prefilter_t* prefilter(const ae::regex::regex_t& rex) { return rex.prefilter().has_value() ? &*rex.prefilter() : nullptr; }
+    inline const ae::regex::prefilter_t* prefilter(const ae::regex::program_ref_t& rex) { return &rex.prefilter; }
+
+    // cells of the region having the literal of the pattern in row-major order,
+    // nullopt if the region is to be scanned: no token index built, no literal or more candidates than region cells
+    inline std::optional<std::vector<cell_addr_t>> indexed_candidates(const Sheet& sheet, const ae::regex::prefilter_t* prefilter, const cell_addr_t& min, const cell_addr_t& max)
+    {
+        const auto* index = sheet.token_index_if_built();
+        if (index == nullptr || prefilter == nullptr)
+            return std::nullopt;
+        const auto last_row = std::min(max.row, sheet.number_of_rows());
+        const auto last_col = std::min(max.col, sheet.number_of_columns());
+        if (min.row >= last_row || min.col >= last_col)
+            return std::nullopt;
+        auto candidates = index->candidates(*prefilter);
+        if (!candidates.has_value() || candidates->size() >= (*last_row - *min.row) * (*last_col - *min.col))
+            return std::nullopt;
+        std::erase_if(*candidates, [&](const cell_addr_t& addr) { return addr.row < min.row || addr.row >= last_row || addr.col < min.col || addr.col >= last_col; });
+        return candidates;
+    }
+
+    // run time (regex_t) and compile time (program_ref_t) patterns
+    template <typename Match, typename Regex> static std::vector<cell_match_t> grep(const Sheet& sheet, const Regex& rex, const cell_addr_t& min, const cell_addr_t& max)
+    {
+        if (const auto candidates = indexed_candidates(sheet, prefilter(rex), min, max); candidates.has_value()) {
+            std::vector<cell_match_t> result;
+            for (const auto& addr : *candidates) {
+                if (Match match; Sheet::matches(rex, match, sheet.row(addr.row)[*addr.col]))
+                    result.push_back(cell_match_view_t{.row = addr.row, .col = addr.col, .match = match}.to_match());
             }
+            return result;
+        }
+
+        return scan_rows<cell_match_t>(sheet, min, max, [&sheet, &rex, &min, &max](std::vector<cell_match_t>& result, nrow_t row) {
+            const auto cells = sheet.row(row);
+            for (auto col = min.col; col < std::min(max.col, ncol_t{cells.size()}); ++col) {
+                // AD_DEBUG("xlsx::grep {} {} \"{}\"", row, col, cells[*col].get());
+                Match match;
+                if (Sheet::matches(rex, match, cells[*col])) {
+                    cell_match_t cm{.row = row, .col = col, .matches = std::vector<std::string>(match.size())};
+                    for (size_t group_no = 0; group_no < match.size(); ++group_no)
+                        cm.matches[group_no] = match.str(group_no);
+                    result.push_back(std::move(cm));
+                }
+            }
+        });
+    }
+
+    // string cells only, like grep with match groups above
+    inline void grep_set(std::vector<cell_match_t>& result, const ae::regex::set_ref_t& rex, const cell_ref_t& cell, nrow_t row, ncol_t col)
+    {
+        if (!cell.is_string())
+            return;
+        const auto text = cell.str(), folded = cell.folded();
+        for (auto mask = ae::regex::search_folded(folded, text, rex); mask != 0; mask &= mask - 1) {
+            const auto pattern_no = static_cast<size_t>(std::countr_zero(mask));
+            ae::regex::match_t match;
+            ae::regex::search_folded(folded, text, match, rex.patterns[pattern_no]);
+            cell_match_t cm{.row = row, .col = col, .matches = std::vector<std::string>(match.size()), .pattern_no = pattern_no};
+            for (size_t group_no = 0; group_no < match.size(); ++group_no)
+                cm.matches[group_no] = match.str(group_no);
+            result.push_back(std::move(cm));
+        }
+    }
+
+    // second cell reported at the position of the first one
+    template <typename Regex> static std::vector<cell_match_t> grepv(const Sheet& sheet, const Regex& rex1, const Regex& rex2, const cell_addr_t& min, const cell_addr_t& max)
+    {
+        const auto query = sheet_query_t{}.at(0, 0, rex1).at(1, 0, rex2, sheet_query_t::capture::yes);
+        std::vector<cell_match_t> result;
+        for (const auto& found : query.find_all(sheet, min, max)) {
+            auto& cm = result.emplace_back(found.cells[1].to_match());
+            cm.row = found.row;
+            cm.col = found.col;
         }
+        return result;
     }
-    return result;
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::cell_match_t> ae::xlsx::v1::Sheet::grep(const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    return ae::xlsx::grep<ae::regex::match_t>(*this, rex, min, max);
 
 } // ae::xlsx::v1::Sheet::grep
 
 // ----------------------------------------------------------------------
 
-std::vector<ae::xlsx::cell_match_t> ae::xlsx::v1::Sheet::grepv(const std::regex& rex1, const std::regex& rex2, const cell_addr_t& min, const cell_addr_t& max) const
+std::vector<ae::xlsx::cell_match_t> ae::xlsx::v1::Sheet::grep(const ae::regex::program_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
 {
-    std::vector<cell_match_t> result;
-    for (auto row = min.row; row < max.row; ++row) {
-        for (auto col = min.col; col < max.col; ++col) {
-            const auto cl1 = cell(row, col);
-            const auto cl2 = cell(row + nrow_t{1}, col);
-            // AD_DEBUG("xlsx::grep {} {} \"{}\"", row, col, cl);
-            std::smatch match;
-            if (matches(rex1, cl1) && matches(rex2, match, cl2)) {
-                cell_match_t cm{.row = row, .col = col, .matches = std::vector<std::string>(match.size())};
-                std::transform(std::cbegin(match), std::cend(match), std::begin(cm.matches), [](const auto& submatch) { return submatch.str(); });
-                result.push_back(std::move(cm));
-            }
+    return ae::xlsx::grep<ae::regex::match_t>(*this, rex, min, max);
+
+} // ae::xlsx::v1::Sheet::grep
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::cell_match_t> ae::xlsx::v1::Sheet::grepv(const ae::regex::regex_t& rex1, const ae::regex::regex_t& rex2, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    return ae::xlsx::grepv(*this, rex1, rex2, min, max);
+
+} // ae::xlsx::v1::Sheet::grepv
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::cell_match_t> ae::xlsx::v1::Sheet::grepv(const ae::regex::program_ref_t& rex1, const ae::regex::program_ref_t& rex2, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    return ae::xlsx::grepv(*this, rex1, rex2, min, max);
+
+} // ae::xlsx::v1::Sheet::grepv
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::cell_match_t> ae::xlsx::v1::Sheet::grep(const ae::regex::set_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    return scan_rows<cell_match_t>(*this, min, max, [this, &rex, &min, &max](std::vector<cell_match_t>& result, nrow_t row) {
+        const auto cells = this->row(row);
+        for (auto col = min.col; col < std::min(max.col, ncol_t{cells.size()}); ++col)
+            grep_set(result, rex, cells[*col], row, col);
+    });
+
+} // ae::xlsx::v1::Sheet::grep
+
+// ----------------------------------------------------------------------
+
+std::vector<ae::xlsx::cell_match_t> ae::xlsx::v1::Sheet::grepv(const ae::regex::program_ref_t& rex1, const ae::regex::set_ref_t& rex2, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    return scan_rows<cell_match_t>(*this, min, max, [this, &rex1, &rex2, &min, &max](std::vector<cell_match_t>& result, nrow_t row) {
+        const auto cells1 = this->row(row), cells2 = this->row(row + nrow_t{1}); // cells2 is empty below the last row
+        for (auto col = min.col; col < std::min(max.col, ncol_t{cells1.size()}); ++col) {
+            if (matches(rex1, cells1[*col]))
+                grep_set(result, rex2, cells2.at(*col), row, col);
         }
-    }
-    return result;
+    });
 
 } // ae::xlsx::v1::Sheet::grepv
 
 // ----------------------------------------------------------------------
+
+ae::xlsx::grep_range_t<ae::regex::regex_t> ae::xlsx::v1::Sheet::grep_lazy(const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    return grep_range_t<ae::regex::regex_t>{*this, rex, min, max, indexed_candidates(*this, prefilter(rex), min, max)};
+
+} // ae::xlsx::v1::Sheet::grep_lazy
+
+// ----------------------------------------------------------------------
+
+ae::xlsx::grep_range_t<ae::regex::program_ref_t> ae::xlsx::v1::Sheet::grep_lazy(const ae::regex::program_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    return grep_range_t<ae::regex::program_ref_t>{*this, rex, min, max, indexed_candidates(*this, prefilter(rex), min, max)};
+
+} // ae::xlsx::v1::Sheet::grep_lazy
+
+// ----------------------------------------------------------------------
+
+std::optional<ae::xlsx::cell_match_view_t> ae::xlsx::v1::Sheet::find_first(const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    const auto range = grep_lazy(rex, min, max);
+    if (const auto found = range.begin(); found != range.end())
+        return *found;
+    return std::nullopt;
+
+} // ae::xlsx::v1::Sheet::find_first
+
+// ----------------------------------------------------------------------
+
+std::optional<ae::xlsx::cell_match_view_t> ae::xlsx::v1::Sheet::find_first(const ae::regex::program_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    const auto range = grep_lazy(rex, min, max);
+    if (const auto found = range.begin(); found != range.end())
+        return *found;
+    return std::nullopt;
+
+} // ae::xlsx::v1::Sheet::find_first
+
+// ----------------------------------------------------------------------
+
+size_t ae::xlsx::v1::Sheet::count(const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    const auto range = grep_lazy(rex, min, max);
+    return static_cast<size_t>(std::ranges::distance(range.begin(), range.end()));
+
+} // ae::xlsx::v1::Sheet::count
+
+// ----------------------------------------------------------------------
+
+size_t ae::xlsx::v1::Sheet::count(const ae::regex::program_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const
+{
+    const auto range = grep_lazy(rex, min, max);
+    return static_cast<size_t>(std::ranges::distance(range.begin(), range.end()));
+
+} // ae::xlsx::v1::Sheet::count
+
+// ----------------------------------------------------------------------
@@ -1,67 +1,19 @@
 #pragma once
 
+#include <atomic>
 #include <variant>
-#include <limits>
-#include <regex>
 #include <optional>
+#include <memory>
+#include <mutex>
 
-#include "ext/fmt.hh"
-#include "ext/date.hh"
-#include "utils/named-type.hh"
+#include "utils/regex-backend.hh"
+#include "xlsx/compact-cell.hh"
 
 // ----------------------------------------------------------------------
 
 namespace ae::xlsx::inline v1
 {
 
-    namespace cell
-    {
-        class empty
-        {
-        };
-        class error
-        {
-        };
-    } // namespace cell
-
-    using cell_t = std::variant<cell::empty, cell::error, bool, std::string, double, long, std::chrono::year_month_day>;
-
-    inline bool is_empty(const cell_t& cell)
-    {
-        return std::visit(
-            []<typename Content>(const Content&) {
-                if constexpr (std::is_same_v<Content, cell::empty>)
-                    return true;
-                else
-                    return false;
-            },
-            cell);
-    }
-
-    inline bool is_date(const cell_t& cell)
-    {
-        return std::visit(
-            []<typename Content>(const Content&) {
-                if constexpr (std::is_same_v<Content, std::chrono::year_month_day>)
-                    return true;
-                else
-                    return false;
-            },
-            cell);
-    }
-
-    inline bool is_string(const cell_t& cell)
-    {
-        return std::visit(
-            []<typename Content>(const Content&) {
-                if constexpr (std::is_same_v<Content, std::string>)
-                    return true;
-                else
-                    return false;
-            },
-            cell);
-    }
-
     // ----------------------------------------------------------------------
 
     // struct cell_span_t
@@ -76,15 +28,6 @@ namespace ae::xlsx::inline v1
 
     // ----------------------------------------------------------------------
 
-    constexpr const auto max_row_col = std::numeric_limits<size_t>::max();
-
-    using nrow_t = named_size_t<struct nrow_t_tag>;
-    using ncol_t = named_size_t<struct ncol_t_tag>;
-
-    template <typename nrowcol> concept NRowCol = std::is_same_v<nrowcol, nrow_t> || std::is_same_v<nrowcol, ncol_t>;
-
-    template <NRowCol nrowcol> constexpr bool valid(nrowcol row_col) { return row_col != nrowcol{max_row_col}; }
-
     struct cell_addr_t
     {
         nrow_t row{max_row_col};
@@ -96,8 +39,28 @@ namespace ae::xlsx::inline v1
         nrow_t row{max_row_col};
         ncol_t col{max_row_col};
         std::vector<std::string> matches{}; // match groups starting with 0
+        size_t pattern_no{0};                // matching pattern of ae::regex::set
     };
 
+    // match found by Sheet::grep_lazy, groups are views into the sheet, valid while the sheet is alive
+    struct cell_match_view_t
+    {
+        nrow_t row{max_row_col};
+        ncol_t col{max_row_col};
+        ae::regex::match_t match{};
+
+        std::string_view operator[](size_t group_no) const { return match[group_no]; }
+
+        cell_match_t to_match() const // groups copied
+        {
+            cell_match_t result{.row = row, .col = col, .matches = std::vector<std::string>(match.size())};
+            for (size_t group_no = 0; group_no < match.size(); ++group_no)
+                result.matches[group_no] = match.str(group_no);
+            return result;
+        }
+    };
+
+    template <typename Regex> class grep_range_t;
 
     template <NRowCol nrowcol> struct range : public std::pair<nrowcol, nrowcol>
     {
@@ -111,6 +74,9 @@ namespace ae::xlsx::inline v1
     using row_range = range<nrow_t>;
     using column_range = range<ncol_t>;
 
+    class cell_type_index_t;
+    class cell_token_index_t;
+
     class Sheet
     {
       public:
@@ -120,81 +86,154 @@ namespace ae::xlsx::inline v1
         virtual nrow_t number_of_rows() const = 0;
         virtual ncol_t number_of_columns() const = 0;
         virtual cell_t cell(nrow_t row, ncol_t col) const = 0;                               // row and col are zero based
+        virtual cell_view_t row(nrow_t row) const = 0;                                       // empty view if outside
+        virtual cell_view_t column(ncol_t col) const = 0;                                    // empty view if outside
         // virtual cell_spans_t cell_spans(nrow_t /*row*/, ncol_t /*col*/) const { return {}; } // row and col are zero based
 
-        static bool matches(const std::regex& re, const cell_t& cell);
-        static bool matches(const std::regex& re, std::smatch& match, const cell_t& cell);
-        bool matches(const std::regex& re, nrow_t row, ncol_t col) const { return matches(re, cell(row, col)); }
+        // run time patterns (see utils/regex-backend.hh), match groups refer to the cell text, keep the cell alive
+        static bool matches(const ae::regex::regex_t& re, const cell_t& cell);
+        static bool matches(const ae::regex::regex_t& re, ae::regex::match_t& match, const cell_t& cell);
+        static bool matches(const ae::regex::regex_t& re, const cell_ref_t& cell);
+        static bool matches(const ae::regex::regex_t& re, ae::regex::match_t& match, const cell_ref_t& cell);
+        bool matches(const ae::regex::regex_t& re, nrow_t row, ncol_t col) const { return matches(re, this->row(row).at(*col)); }
+        // compile time patterns (see utils/static-regex.hh), match groups refer to the cell text, keep the cell alive
+        static bool matches(const ae::regex::program_ref_t& re, const cell_t& cell);
+        static bool matches(const ae::regex::program_ref_t& re, ae::regex::match_t& match, const cell_t& cell);
+        static bool matches(const ae::regex::program_ref_t& re, const cell_ref_t& cell);
+        static bool matches(const ae::regex::program_ref_t& re, ae::regex::match_t& match, const cell_ref_t& cell);
+        bool matches(const ae::regex::program_ref_t& re, nrow_t row, ncol_t col) const { return matches(re, this->row(row).at(*col)); }
+        std::string_view text(nrow_t row, ncol_t col) const { return this->row(row).at(*col).text(); } // cell formatted with "{}", rendered once per sheet, empty if outside
         bool is_date(nrow_t row, ncol_t col) const { return ae::xlsx::is_date(cell(row, col)); }
         size_t size(const cell_t& cell) const;
         size_t size(nrow_t row, ncol_t col) const { return size(cell(row, col)); }
 
         bool maybe_titer(const cell_t& cell) const;
+        bool maybe_titer(const cell_ref_t& cell) const;
         bool maybe_titer(nrow_t row, ncol_t col) const { return maybe_titer(cell(row, col)); }
         column_range titer_range(nrow_t row) const; // returns column range, returns empty range if not found
 
+        const cell_type_index_t& type_index() const; // built on first use
+
+        // built on first use, then grep() looks only at the cells having the literal of the pattern (see cell-index.hh)
+        const cell_token_index_t& token_index() const;
+        const cell_token_index_t* token_index_if_built() const { return token_index_built_.load(std::memory_order_acquire) ? token_index_.get() : nullptr; }
+
         cell_addr_t min_cell() const { return {nrow_t{0ul}, ncol_t{0ul}}; }
         cell_addr_t max_cell() const { return {number_of_rows(), number_of_columns()}; }
 
-        std::vector<cell_match_t> grep(const std::regex& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+        std::vector<cell_match_t> grep(const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
 
         // finds sets of two cells, the second one is right below the the first one
         // returns references to the second cells
-        std::vector<cell_match_t> grepv(const std::regex& rex1, const std::regex& rex2, const cell_addr_t& min, const cell_addr_t& max) const;
+        std::vector<cell_match_t> grepv(const ae::regex::regex_t& rex1, const ae::regex::regex_t& rex2, const cell_addr_t& min, const cell_addr_t& max) const;
+
+        std::vector<cell_match_t> grep(const ae::regex::program_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+        std::vector<cell_match_t> grepv(const ae::regex::program_ref_t& rex1, const ae::regex::program_ref_t& rex2, const cell_addr_t& min, const cell_addr_t& max) const;
+
+        // all patterns of the set are looked for in one scan of each cell, a cell matching several patterns is reported for each of them
+        std::vector<cell_match_t> grep(const ae::regex::set_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+        std::vector<cell_match_t> grepv(const ae::regex::program_ref_t& rex1, const ae::regex::set_ref_t& rex2, const cell_addr_t& min, const cell_addr_t& max) const;
+
+        // the same matches as grep() in the same order, found one by one while iterating,
+        // scanning stops when iteration stops
+        //   for (const auto& found : sheet.grep_lazy(re, min, max)) ... found.row found.col found[1]
+        grep_range_t<ae::regex::regex_t> grep_lazy(const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+        grep_range_t<ae::regex::program_ref_t> grep_lazy(const ae::regex::program_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+        std::optional<cell_match_view_t> find_first(const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+        std::optional<cell_match_view_t> find_first(const ae::regex::program_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+        size_t count(const ae::regex::regex_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+        size_t count(const ae::regex::program_ref_t& rex, const cell_addr_t& min, const cell_addr_t& max) const;
+
+      private:
+        mutable std::once_flag type_index_built_{};
+        mutable std::shared_ptr<const cell_type_index_t> type_index_{};
+        mutable std::once_flag token_index_once_{};
+        mutable std::atomic<bool> token_index_built_{false};
+        mutable std::shared_ptr<const cell_token_index_t> token_index_{};
     };
 
-} // namespace ae::xlsx::inline v1
-
-// ----------------------------------------------------------------------
-
-template <> struct fmt::formatter<ae::xlsx::cell_t> : fmt::formatter<ae::fmt_helper::default_formatter>
-{
-    template <typename FormatCtx> auto format(const ae::xlsx::cell_t& cell, FormatCtx& ctx)
-    {
-        std::visit(
-            [&ctx]<typename Content>(const Content& arg) {
-                if constexpr (std::is_same_v<Content, ae::xlsx::cell::empty>)
-                    ; // format_to(ctx.out(), "<empty>");
-                else if constexpr (std::is_same_v<Content, ae::xlsx::cell::error>)
-                    format_to(ctx.out(), "<error>");
-                else if constexpr (std::is_same_v<Content, bool>)
-                    format_to(ctx.out(), "{}", arg);
-                else if constexpr (std::is_same_v<Content, std::string> || std::is_same_v<Content, double> || std::is_same_v<Content, long>)
-                    format_to(ctx.out(), "{}", arg);
-                else if constexpr (std::is_same_v<Content, std::chrono::year_month_day>)
-                    format_to(ctx.out(), "{}", arg);
-                else
-                    format_to(ctx.out(), "<*unknown*>");
-            },
-            cell);
-        return ctx.out();
-    }
-};
+    // ----------------------------------------------------------------------
 
-template <> struct fmt::formatter<ae::xlsx::nrow_t> : fmt::formatter<ae::fmt_helper::default_formatter>
-{
-    template <typename FormatCtx> auto format(ae::xlsx::nrow_t row, FormatCtx& ctx)
+    // cells of the region [min, max) matching rex in row-major order, sheet must outlive the range;
+    // candidates: cells of the region having the literal of rex (token index), only they are looked at
+    template <typename Regex> class grep_range_t
     {
-        return format_to(ctx.out(), "{}", *row + 1);
-    }
-};
+      public:
+        class iterator
+        {
+          public:
+            using difference_type = ssize_t;
+            using value_type = cell_match_view_t;
+
+            iterator() = default;
+            explicit iterator(const grep_range_t& range) : range_{&range}, row_{range.min_.row}, col_{range.min_.col} { advance(); }
+
+            const cell_match_view_t& operator*() const { return current_; }
+            const cell_match_view_t* operator->() const { return &current_; }
+            iterator& operator++()
+            {
+                advance();
+                return *this;
+            }
+            void operator++(int) { advance(); }
+            bool operator==(std::default_sentinel_t) const { return range_ == nullptr; }
+
+          private:
+            const grep_range_t* range_{nullptr}; // nullptr at the end
+            nrow_t row_{0};                       // next cell to look at
+            ncol_t col_{0};
+            size_t candidate_no_{0}; // next candidate to look at
+            cell_match_view_t current_{};
+
+            void advance()
+            {
+                const auto& sheet = *range_->sheet_;
+                if (range_->candidates_.has_value()) {
+                    while (candidate_no_ < range_->candidates_->size()) {
+                        const auto addr = (*range_->candidates_)[candidate_no_++];
+                        if (Sheet::matches(range_->rex_, current_.match, sheet.row(addr.row)[*addr.col])) {
+                            current_.row = addr.row;
+                            current_.col = addr.col;
+                            return;
+                        }
+                    }
+                    range_ = nullptr;
+                    return;
+                }
+                for (const auto last_row = std::min(range_->max_.row, sheet.number_of_rows()); row_ < last_row; ++row_, col_ = range_->min_.col) {
+                    const auto cells = sheet.row(row_);
+                    for (const auto last_col = std::min(range_->max_.col, ncol_t{cells.size()}); col_ < last_col; ++col_) {
+                        if (Sheet::matches(range_->rex_, current_.match, cells[*col_])) {
+                            current_.row = row_;
+                            current_.col = col_;
+                            ++col_;
+                            return;
+                        }
+                    }
+                }
+                range_ = nullptr;
+            }
+        };
 
-template <> struct fmt::formatter<ae::xlsx::ncol_t> : fmt::formatter<ae::fmt_helper::default_formatter>
-{
-    template <typename FormatCtx> auto format(ae::xlsx::ncol_t col, FormatCtx& ctx)
-    {
-        auto coll = *col;
-        std::string nn;
-        while (true) {
-            nn.append(1, (coll % 26) + 'A');
-            if (coll < 26)
-                break;
-            coll = coll / 26 - 1;
+        grep_range_t(const Sheet& sheet, const Regex& rex, const cell_addr_t& min, const cell_addr_t& max, std::optional<std::vector<cell_addr_t>> candidates = std::nullopt)
+            : sheet_{&sheet}, rex_{rex}, min_{min}, max_{max}, candidates_{std::move(candidates)}
+        {
         }
-        std::reverse(std::begin(nn), std::end(nn));
-        return format_to(ctx.out(), "{}", nn);
-    }
-};
+
+        iterator begin() const { return iterator{*this}; }
+        std::default_sentinel_t end() const { return {}; }
+
+      private:
+        const Sheet* sheet_;
+        Regex rex_;
+        cell_addr_t min_;
+        cell_addr_t max_;
+        std::optional<std::vector<cell_addr_t>> candidates_;
+    };
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
 
 template <> struct fmt::formatter<ae::xlsx::cell_addr_t> : fmt::formatter<ae::fmt_helper::default_formatter>
 {
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ----------------------------------------------------------------------
+
+namespace ae::xlsx::inline v1
+{
+    // Recognizes cell text that may contain a titer, single pass, no allocation.
+    // Accepted language (case insensitive, \s is space, \t, \n, \v, \f, \r):
+    //   ^\s*(<|>|,|(?:<|>|\xEF\xBC\x9C)?\s*[1-9][0-9]{0,5}|N[DAT]|QNS|\*)\s*$
+    // "\xEF\xBC\x9C" is unicode Fullwidth Less-Than Sign &#xFF1C; (NIID)
+    // ">" and "," - perhaps typos in Crick tables
+
+    struct titer_token_t
+    {
+        enum class kind_t { invalid, less, more, comma, number, less_number, more_number, not_done, not_available, not_tested, qns, star };
+
+        kind_t kind{kind_t::invalid};
+        std::string_view number{}; // digits for number, less_number, more_number
+
+        constexpr bool valid() const { return kind != kind_t::invalid; }
+        constexpr operator bool() const { return valid(); }
+    };
+
+    namespace detail
+    {
+        constexpr bool titer_space(char cc) { return cc == ' ' || cc == '\t' || cc == '\n' || cc == '\v' || cc == '\f' || cc == '\r'; }
+        constexpr bool titer_digit(char cc) { return cc >= '0' && cc <= '9'; }
+        constexpr char titer_upper(char cc) { return (cc >= 'a' && cc <= 'z') ? static_cast<char>(cc - 'a' + 'A') : cc; }
+
+    } // namespace detail
+
+    constexpr titer_token_t lex_titer(std::string_view source)
+    {
+        using kind_t = titer_token_t::kind_t;
+
+        size_t pos{0};
+        const auto skip_space = [&source, &pos] {
+            while (pos < source.size() && detail::titer_space(source[pos]))
+                ++pos;
+        };
+        // only trailing space allowed
+        const auto at_end = [&source, &pos, &skip_space] {
+            skip_space();
+            return pos == source.size();
+        };
+        const auto token = [&at_end](kind_t kind, std::string_view number = {}) { return at_end() ? titer_token_t{kind, number} : titer_token_t{}; };
+
+        // [1-9][0-9]{0,5}
+        const auto number = [&source, &pos, &token](kind_t kind) {
+            if (pos == source.size() || source[pos] < '1' || source[pos] > '9')
+                return titer_token_t{};
+            const auto start = pos;
+            while (pos < source.size() && detail::titer_digit(source[pos]) && (pos - start) < 6)
+                ++pos;
+            return token(kind, source.substr(start, pos - start));
+        };
+
+        // optional \s* after the prefix, then number or nothing
+        const auto prefixed = [&source, &pos, &skip_space, &number](kind_t alone, kind_t with_number) {
+            skip_space();
+            if (pos == source.size())
+                return alone == kind_t::invalid ? titer_token_t{} : titer_token_t{alone};
+            if (detail::titer_digit(source[pos]))
+                return number(with_number);
+            return titer_token_t{};
+        };
+
+        const auto letters = [&source, &pos, &token](std::string_view expected, kind_t kind) {
+            if ((source.size() - pos) < expected.size())
+                return titer_token_t{};
+            for (const auto cc : expected) {
+                if (detail::titer_upper(source[pos]) != cc)
+                    return titer_token_t{};
+                ++pos;
+            }
+            return token(kind);
+        };
+
+        skip_space();
+        if (pos == source.size())
+            return {};
+
+        switch (detail::titer_upper(source[pos])) {
+            case '<':
+                ++pos;
+                return prefixed(kind_t::less, kind_t::less_number);
+            case '>':
+                ++pos;
+                return prefixed(kind_t::more, kind_t::more_number);
+            case ',':
+                ++pos;
+                return token(kind_t::comma);
+            case '*':
+                ++pos;
+                return token(kind_t::star);
+            case '\xEF':
+                if (source.substr(pos, 3) != "\xEF\xBC\x9C")
+                    return {};
+                pos += 3;
+                return prefixed(kind_t::invalid, kind_t::less_number);
+            case 'N':
+                if ((source.size() - pos) < 2)
+                    return {};
+                switch (detail::titer_upper(source[pos + 1])) {
+                    case 'D':
+                        return letters("ND", kind_t::not_done);
+                    case 'A':
+                        return letters("NA", kind_t::not_available);
+                    case 'T':
+                        return letters("NT", kind_t::not_tested);
+                    default:
+                        return {};
+                }
+            case 'Q':
+                return letters("QNS", kind_t::qns);
+            default:
+                return number(kind_t::number);
+        }
+    }
+
+    constexpr bool is_titer(std::string_view source) { return lex_titer(source).valid(); }
+
+    // ----------------------------------------------------------------------
+
+    // 5 and 10 * 2^n up to the 6 digits accepted by lex_titer
+    inline constexpr const std::array<uint32_t, 18> legal_titers = []() {
+        std::array<uint32_t, 18> result{5};
+        for (size_t no = 1; no < result.size(); ++no)
+            result[no] = uint32_t{10} << (no - 1);
+        return result;
+    }();
+    static_assert(std::is_sorted(std::begin(legal_titers), std::end(legal_titers)));
+    static_assert(legal_titers.back() <= 999999 && legal_titers.back() * 2 > 999999, "legal_titers must cover the numbers accepted by lex_titer");
+
+    constexpr bool is_legal_titer(uint32_t value) { return std::binary_search(std::begin(legal_titers), std::end(legal_titers), value); }
+
+    // Titer in 4 bytes, parsed from and formatted to the strings produced by
+    // Extractor::titer(): "1280" "<10" ">5120" "<" ">" "*" "ND" "NA" "NT" "QNS" ","
+    // and Crick PRN "2-fold/read" pairs, e.g. "40/57", "<40/<40", "</<".
+    // Value is kept as is (PRN read titers are not powers of 2), log2() for
+    // statistics. Letters are case insensitive and space is allowed where
+    // lex_titer allows it, to_string() produces the canonical form.
+    class titer_t
+    {
+      public:
+        enum class qualifier_t : uint8_t { invalid, exact, less, more, dont_care, not_done, not_available, not_tested, qns, comma };
+
+        constexpr titer_t() = default;
+
+        static constexpr titer_t parse(std::string_view source); // invalid titer if not recognized
+
+        constexpr qualifier_t qualifier() const { return static_cast<qualifier_t>(data_ >> qualifier_shift); }
+        constexpr uint32_t value() const { return data_ & value_mask; } // 0 if none, e.g. "<", "*"
+        constexpr bool valid() const { return qualifier() != qualifier_t::invalid; }
+        constexpr bool is_pair() const { return fold_index() != 0; }
+        constexpr titer_t two_fold() const // first titer of a Crick PRN pair, invalid if not a pair
+        {
+            if (!is_pair())
+                return {};
+            return titer_t{(data_ & fold_less_bit) ? qualifier_t::less : qualifier_t::exact, fold_index() == fold_none ? 0 : legal_titers[fold_index() - 1]};
+        }
+        constexpr titer_t read() const { return titer_t{qualifier(), value()}; } // titer without the two_fold part
+
+        constexpr bool is_legal() const { return value() == 0 || is_legal_titer(value()); } // read titer of a pair is not checked by the PRN protocol
+        double log2() const { return std::log2(static_cast<double>(value()) / 10.0); } // exact integer for legal values, meaningful if value() > 0
+
+        std::string to_string() const
+        {
+            std::string result;
+            append_to(result);
+            return result;
+        }
+        void append_to(std::string& target) const;
+
+        constexpr bool operator==(const titer_t&) const = default;
+
+      private:
+        // qualifier:4 fold_less:1 fold_index:5 value:22
+        static constexpr const uint32_t qualifier_shift{28}, fold_less_bit{uint32_t{1} << 27}, fold_shift{22}, fold_mask{0x1F}, value_mask{(uint32_t{1} << fold_shift) - 1};
+        static constexpr const uint32_t fold_none{fold_mask}; // "<" without value in the 2-fold part
+        static_assert(legal_titers.size() < fold_none && 999999 <= value_mask);
+
+        uint32_t data_{0};
+
+        constexpr titer_t(qualifier_t qualifier, uint32_t value) : data_{(static_cast<uint32_t>(qualifier) << qualifier_shift) | value} {}
+        constexpr uint32_t fold_index() const { return (data_ >> fold_shift) & fold_mask; } // 0: not a pair, fold_none: no value, otherwise index in legal_titers + 1
+
+        static constexpr titer_t from_token(const titer_token_t& token);
+    };
+
+    static_assert(sizeof(titer_t) == 4);
+
+    constexpr titer_t titer_t::from_token(const titer_token_t& token)
+    {
+        using kind_t = titer_token_t::kind_t;
+        uint32_t value{0};
+        for (const auto digit : token.number)
+            value = value * 10 + static_cast<uint32_t>(digit - '0');
+        switch (token.kind) {
+            case kind_t::invalid:
+                return {};
+            case kind_t::number:
+                return {qualifier_t::exact, value};
+            case kind_t::less:
+            case kind_t::less_number:
+                return {qualifier_t::less, value};
+            case kind_t::more:
+            case kind_t::more_number:
+                return {qualifier_t::more, value};
+            case kind_t::comma:
+                return {qualifier_t::comma, 0};
+            case kind_t::star:
+                return {qualifier_t::dont_care, 0};
+            case kind_t::not_done:
+                return {qualifier_t::not_done, 0};
+            case kind_t::not_available:
+                return {qualifier_t::not_available, 0};
+            case kind_t::not_tested:
+                return {qualifier_t::not_tested, 0};
+            case kind_t::qns:
+                return {qualifier_t::qns, 0};
+        }
+        return {};
+    }
+
+    constexpr titer_t titer_t::parse(std::string_view source)
+    {
+        const auto slash = source.find('/');
+        if (slash == std::string_view::npos)
+            return from_token(lex_titer(source));
+
+        // Crick PRN pair: 2-fold titer (legal value, optionally less than) / read titer
+        const auto two_fold = from_token(lex_titer(source.substr(0, slash)));
+        auto read = from_token(lex_titer(source.substr(slash + 1)));
+        if (!read.valid() || (two_fold.qualifier() != qualifier_t::exact && two_fold.qualifier() != qualifier_t::less) || (two_fold.qualifier() == qualifier_t::exact && two_fold.value() == 0))
+            return {};
+        uint32_t fold_index{fold_none};
+        if (two_fold.value() != 0) {
+            const auto found = std::lower_bound(std::begin(legal_titers), std::end(legal_titers), two_fold.value());
+            if (found == std::end(legal_titers) || *found != two_fold.value())
+                return {};
+            fold_index = static_cast<uint32_t>(found - std::begin(legal_titers)) + 1;
+        }
+        read.data_ |= (fold_index << fold_shift) | (two_fold.qualifier() == qualifier_t::less ? fold_less_bit : 0);
+        return read;
+    }
+
+    inline void titer_t::append_to(std::string& target) const
+    {
+        if (is_pair()) {
+            two_fold().append_to(target);
+            target.push_back('/');
+            read().append_to(target);
+            return;
+        }
+        switch (qualifier()) {
+            case qualifier_t::invalid:
+                return;
+            case qualifier_t::exact:
+                break;
+            case qualifier_t::less:
+                target.push_back('<');
+                break;
+            case qualifier_t::more:
+                target.push_back('>');
+                break;
+            case qualifier_t::dont_care:
+                target.push_back('*');
+                return;
+            case qualifier_t::not_done:
+                target.append("ND");
+                return;
+            case qualifier_t::not_available:
+                target.append("NA");
+                return;
+            case qualifier_t::not_tested:
+                target.append("NT");
+                return;
+            case qualifier_t::qns:
+                target.append("QNS");
+                return;
+            case qualifier_t::comma:
+                target.push_back(',');
+                return;
+        }
+        if (value() != 0)
+            target.append(std::to_string(value()));
+    }
+
+    // round trip of the canonical forms, checked at compile time
+    static_assert(titer_t::parse("<10").qualifier() == titer_t::qualifier_t::less && titer_t::parse("<10").value() == 10);
+    static_assert(titer_t::parse("1280").is_legal() && !titer_t::parse("1000").is_legal() && titer_t::parse("1000").valid());
+    static_assert(titer_t::parse("<40/57").two_fold() == titer_t::parse("<40") && titer_t::parse("<40/57").read() == titer_t::parse("57"));
+    static_assert(titer_t::parse("</<").two_fold() == titer_t::parse("<") && !titer_t::parse("30/57").valid() && !titer_t::parse("ND/57").valid());
+    static_assert(titer_t::parse("nd") == titer_t::parse("ND") && !titer_t::parse("ND1").valid() && !titer_t::parse("").valid());
+
+} // namespace ae::xlsx::inline v1
+
+// ----------------------------------------------------------------------
@@ -3,7 +3,7 @@
 #include "ext/filesystem.hh"
 #include "ext/xlnt.hh"
 #include "utils/float.hh"
-#include "xlsx/sheet.hh"
+#include "xlsx/materialized-sheet.hh"
 
 // ----------------------------------------------------------------------
 
@@ -13,52 +13,52 @@ namespace ae::xlsx::inline v1
     {
         class Doc;
 
-        class Sheet : public ae::xlsx::Sheet
+        // Cells are materialized in one pass, the used range is the bounding
+        // box of the non-empty ones. xlnt 1.5 has no public iterator over its
+        // cell map: rows(true) still walks every position of
+        // calculate_dimension(), but costs one has_cell() lookup per absent
+        // position instead of a cell() copy, and there is no separate pass
+        // over highest_row() x highest_column() to trim empty rows/columns
+        class Sheet : public ae::xlsx::MaterializedSheet
         {
           public:
-            Sheet(::xlnt::worksheet&& src) : sheet_{std::move(src)}, number_of_rows_{sheet_.highest_row()}, number_of_columns_{sheet_.highest_column().index}
+            Sheet(::xlnt::worksheet&& src)
             {
-                if (number_of_columns_ > ncol_t{0} && number_of_rows_ > nrow_t{0}) {
-                    // remove last empty columns
-                    const auto is_empty_col = [this](ncol_t col) {
-                        for (nrow_t row{0}; row < number_of_rows_; ++row) {
-                            if (!is_empty(cell(row, col)))
-                                return false;
+                name_ = src.title();
+
+                struct populated_t
+                {
+                    nrow_t row;
+                    ncol_t col;
+                    compact_cell_t cell;
+                };
+
+                std::vector<populated_t> populated;
+                nrow_t rows{0};
+                ncol_t cols{0};
+                for (const auto& src_row : src.rows(true)) { // skip_null: positions not stored by xlnt are skipped after has_cell()
+                    for (const auto& src_cell : src_row) {
+                        const auto ref = src_cell.reference();
+                        const nrow_t row{ref.row() - 1};
+                        const ncol_t col{ref.column_index() - 1};
+                        if (const auto value = cell_value(src_cell); !is_empty(value)) {
+                            populated.push_back(populated_t{row, col, store_.compact(value)});
+                            rows = std::max(rows, row + nrow_t{1});
+                            cols = std::max(cols, col + ncol_t{1});
                         }
-                        return true;
-                    };
-
-                    for (ncol_t col{number_of_columns_ - ncol_t{1}}; col > ncol_t{0}; --col) {
-                        if (!is_empty_col(col))
-                            break;
-                        --number_of_columns_;
-                    }
-
-                    // remove last empty rows
-                    const auto is_empty_row = [this](nrow_t row) {
-                        for (ncol_t col{0}; col < number_of_columns_; ++col) {
-                            if (!is_empty(cell(row, col)))
-                                return false;
-                        }
-                        return true;
-                    };
-
-                    for (nrow_t row{number_of_rows_ - nrow_t{1}}; row > nrow_t{0}; --row) {
-                        if (!is_empty_row(row))
-                            break;
-                        --number_of_rows_;
                     }
                 }
-            }
 
-            std::string name() const override { return sheet_.title(); }
-            xlsx::nrow_t number_of_rows() const override { return number_of_rows_; }
-            xlsx::ncol_t number_of_columns() const override { return number_of_columns_; }
+                store_.resize(rows, cols);
+                for (const auto& cell : populated)
+                    store_.at(cell.row, cell.col) = cell.cell;
+                store_.finalize();
+            }
 
-            static inline std::chrono::year_month_day make_date(const ::xlnt::datetime& dt, xlsx::nrow_t /*row*/, xlsx::ncol_t /*col*/)
+            static inline std::chrono::year_month_day make_date(const ::xlnt::datetime& dt)
             {
                 // if (dt.hour || dt.minute || dt.second || dt.microsecond)
-                //     AD_WARNING("xlnt datetime at {:c}{} contains time: {}", col + 'A', row + 1, dt.to_string());
+                //     AD_WARNING("xlnt datetime contains time: {}", dt.to_string());
                 return std::chrono::year{dt.year} / std::chrono::month{static_cast<unsigned>(dt.month)} / dt.day;
             }
 
@@ -72,13 +72,8 @@ namespace ae::xlsx::inline v1
                 }
             }
 
-            ae::xlsx::cell_t cell(xlsx::nrow_t row, xlsx::ncol_t col) const override // row and col are zero based
+            static inline ae::xlsx::cell_t cell_value(const ::xlnt::cell& cell)
             {
-                const ::xlnt::cell_reference ref{static_cast<::xlnt::column_t::index_t>(*col + 1), static_cast<::xlnt::row_t>(*row + 1)};
-                if (!sheet_.has_cell(ref))
-                    return ae::xlsx::cell::empty{};
-
-                const auto cell = sheet_.cell(ref);
                 switch (cell.data_type()) { // ~/AD/build/ae-build/build/xlnt/include/xlnt/cell/cell_type.hpp
                     case ::xlnt::cell_type::empty:
                         return ae::xlsx::cell::empty{};
@@ -93,13 +88,13 @@ namespace ae::xlsx::inline v1
                             return ae::xlsx::cell::empty{};
                     case ::xlnt::cell_type::number:
                         if (is_date(cell))
-                            return make_date(cell.value<::xlnt::datetime>(), row, col);
+                            return make_date(cell.value<::xlnt::datetime>());
                         else if (const auto vald = cell.value<double>(); !float_equal(vald, std::round(vald)))
                             return vald;
                         else
                             return static_cast<long>(cell.value<long long>());
                     case ::xlnt::cell_type::date:
-                        return make_date(cell.value<::xlnt::datetime>(), row, col);
+                        return make_date(cell.value<::xlnt::datetime>());
                     case ::xlnt::cell_type::error:
                         return ae::xlsx::cell::error{};
                 }
@@ -145,22 +140,30 @@ namespace ae::xlsx::inline v1
             //     return spans;
             // }
 
-          private:
-            ::xlnt::worksheet sheet_;
-            xlsx::nrow_t number_of_rows_;
-            xlsx::ncol_t number_of_columns_;
         };
 
         class Doc
         {
           public:
-            Doc(const std::filesystem::path& filename) : workbook_{::xlnt::path{std::string{filename}}} {}
+            Doc(const std::filesystem::path& filename) : workbook_{::xlnt::path{std::string{filename}}}, sheets_(workbook_.sheet_count()) {}
 
             size_t number_of_sheets() const { return workbook_.sheet_count(); }
-            std::shared_ptr<ae::xlsx::Sheet> sheet(size_t sheet_no) { return std::make_shared<Sheet>(workbook_.sheet_by_index(sheet_no)); }
+
+            // sheet is materialized on the first call and cached
+            std::shared_ptr<ae::xlsx::Sheet> sheet(size_t sheet_no)
+            {
+                auto& cached = sheets_.at(sheet_no);
+                if (!cached)
+                    cached = std::make_shared<Sheet>(workbook_.sheet_by_index(sheet_no));
+                return cached;
+            }
+
+            // drop cached sheet, it is still alive while referenced elsewhere
+            void release(size_t sheet_no) { sheets_.at(sheet_no).reset(); }
 
           private:
             ::xlnt::workbook workbook_;
+            std::vector<std::shared_ptr<Sheet>> sheets_;
         };
 
     } // namespace xlnt
@@ -30,6 +30,12 @@ namespace ae::xlsx::inline v1
             return std::visit([sheet_no](const auto& ptr) { return ptr->sheet(sheet_no); }, doc_);
         }
 
+        // drop sheet cached by the doc
+        void release(size_t sheet_no)
+        {
+            std::visit([sheet_no](const auto& ptr) { ptr->release(sheet_no); }, doc_);
+        }
+
         // protected
         Doc(const std::filesystem::path& filename)
         {